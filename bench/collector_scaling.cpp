@@ -0,0 +1,47 @@
+// Scaling of the /proc scan with collector_threads: SystemInfo::updateStats()
+// on the real /proc, timed for every thread count from 1 to the number of
+// hardware threads. Steady-state ticks, after one warm-up tick that opens
+// the cached stat descriptors.
+//
+//   bench_collector_scaling [ticks] [max_threads]
+
+#include "system_info.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 50;
+    if (ticks <= 0) ticks = 1;
+    int max_threads = argc > 2 ? std::atoi(argv[2])
+                               : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (max_threads <= 0) max_threads = 1;
+
+    MtopConfig config;
+    config.max_processes = 20;
+    config.show_kernel_threads = true;
+
+    std::printf("%u hardware threads, %d ticks per run\n", std::thread::hardware_concurrency(), ticks);
+    std::printf("threads   processes   ms/tick   ns/process   speed-up\n");
+
+    double single = 0.0;
+    for (int threads = 1; threads <= max_threads; ++threads) {
+        config.collector_threads = threads;
+        SystemInfo info(config);
+        info.updateStats();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            info.updateStats();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ticks;
+        int processes = info.getStats()->process_count;
+        if (threads == 1) single = ms;
+
+        std::printf("%7d   %9d   %7.2f   %10.0f   %7.2fx\n", threads, processes, ms,
+                    processes > 0 ? ms * 1e6 / processes : 0.0, single / ms);
+    }
+    return 0;
+}
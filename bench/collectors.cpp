@@ -0,0 +1,127 @@
+// Cost of one process scan through the ProcessCollector interface: procfs
+// (with and without the cached stat descriptors) against taskstats, per
+// 1000 tasks of the real /proc. Also counts the processes whose UID or
+// start time differ between the two collectors, which must stay zero.
+//
+//   bench_collectors [rounds]
+//
+// taskstats needs CAP_NET_ADMIN; without it only procfs is measured.
+
+#include "process_collector.hpp"
+#include "proc_parser.hpp"
+#include "system_info.hpp"
+#include "taskstats.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+struct Scan {
+    std::vector<ProcessInfo> infos;
+    std::vector<ProcScanTask> tasks;
+};
+
+Scan makeScan(const std::vector<int>& pids, bool keep_fds) {
+    Scan scan;
+    scan.infos.resize(pids.size());
+    for (size_t i = 0; i < pids.size(); ++i) {
+        scan.tasks.push_back(ProcScanTask{pids[i], 0, -1, -1, keep_fds, false, &scan.infos[i], true, false});
+    }
+    return scan;
+}
+
+// Что SystemInfo делает между тиками: новые дескрипторы в кэш, UID не перечитывается
+void settle(Scan& scan) {
+    for (auto& task : scan.tasks) {
+        if (task.new_fd >= 0) {
+            if (task.fd >= 0) close(task.fd);
+            task.fd = task.new_fd;
+            task.new_fd = -1;
+        }
+        task.stale = false;
+        task.check_uid = false;
+    }
+}
+
+void release(Scan& scan) {
+    for (auto& task : scan.tasks) {
+        if (task.fd >= 0) close(task.fd);
+        if (task.new_fd >= 0) close(task.new_fd);
+    }
+}
+
+// Микросекунды на 1000 задач; первый проход (UID, открытие fd) не считается
+double usPer1k(ProcessCollector& collector, Scan& scan, int rounds) {
+    collector.collect(0, scan.tasks.data(), scan.tasks.size());
+    settle(scan);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        collector.collect(0, scan.tasks.data(), scan.tasks.size());
+        settle(scan);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return us * 1000.0 / (static_cast<double>(rounds) * static_cast<double>(scan.tasks.size()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (rounds <= 0) rounds = 1;
+
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    std::vector<int> pids;
+    if (!listProcPids(proc_fd, pids)) {
+        std::fprintf(stderr, "cannot list /proc\n");
+        return 1;
+    }
+    std::printf("%zu processes, %d rounds\n", pids.size(), rounds);
+
+    ProcfsCollector procfs(proc_fd);
+    procfs.prepare(1);
+
+    Scan uncached = makeScan(pids, false);
+    std::printf("procfs, no fd cache   %10.0f us/1k tasks\n", usPer1k(procfs, uncached, rounds));
+
+    Scan cached = makeScan(pids, true);
+    std::printf("procfs, cached fds    %10.0f us/1k tasks\n", usPer1k(procfs, cached, rounds));
+
+    TaskstatsCollector taskstats(proc_fd);
+    std::string error;
+    if (!taskstats.open(error)) {
+        std::printf("taskstats             skipped: %s\n", error.c_str());
+        release(cached);
+        close(proc_fd);
+        return 0;
+    }
+    taskstats.prepare(1);
+
+    Scan binary = makeScan(pids, false);
+    std::printf("taskstats             %10.0f us/1k tasks\n", usPer1k(taskstats, binary, rounds));
+
+    // Одни и те же процессы обоими сборщиками подряд, UID перечитывается
+    Scan a = makeScan(pids, false);
+    Scan b = makeScan(pids, false);
+    procfs.collect(0, a.tasks.data(), a.tasks.size());
+    taskstats.collect(0, b.tasks.data(), b.tasks.size());
+
+    size_t compared = 0, uid_diff = 0, start_diff = 0;
+    for (size_t i = 0; i < pids.size(); ++i) {
+        if (!a.tasks[i].ok || !b.tasks[i].ok) continue;
+        compared++;
+        if (a.infos[i].uid != b.infos[i].uid) uid_diff++;
+        if (!sameStartTime(a.infos[i].start_time, b.infos[i].start_time)) start_diff++;
+    }
+    std::printf("%zu processes read by both: %zu UID and %zu start time mismatches\n",
+                compared, uid_diff, start_diff);
+
+    release(cached);
+    close(proc_fd);
+    return uid_diff == 0 && start_diff == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// Microbenchmark of /proc/PID/stat parsing: the original istringstream
+// tokenizer against parseProcStat() on the same captured lines, and both
+// again with the file read included.
+//
+//   bench_stat_parser [rounds]
+
+#include "proc_parser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+volatile uint64_t result_sink; // keeps the parsed values alive
+
+struct Parsed {
+    char state = '?';
+    int ppid = 0;
+    uint64_t rss = 0;
+};
+
+// Разбор из исходной версии readProcesses(): substr, istringstream и
+// vector<string> всех полей
+bool parseOld(const std::string& stat_line, std::string& name, Parsed& out) {
+    size_t first_paren = stat_line.find('(');
+    size_t last_paren = stat_line.rfind(')');
+    if (first_paren == std::string::npos || last_paren == std::string::npos) {
+        return false;
+    }
+    name = stat_line.substr(first_paren + 1, last_paren - first_paren - 1);
+
+    std::string remaining = stat_line.substr(last_paren + 1);
+    std::istringstream iss(remaining);
+    std::vector<std::string> fields;
+    std::string field;
+    while (iss >> field) {
+        fields.push_back(field);
+    }
+    if (fields.size() < 22) return false;
+
+    out.state = fields[0][0];
+    out.ppid = std::stoi(fields[1]);
+    out.rss = std::stoull(fields[21]);
+    return true;
+}
+
+bool parseNew(const char* data, size_t len, Parsed& out) {
+    ProcStat stat;
+    if (!parseProcStat(data, len, stat)) return false;
+    out.state = stat.state;
+    out.ppid = stat.ppid;
+    out.rss = stat.rss;
+    return true;
+}
+
+double nsPerItem(std::chrono::steady_clock::duration elapsed, size_t items) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(items);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (rounds <= 0) rounds = 1;
+
+    int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    std::vector<int> pids;
+    if (!listProcPids(proc_fd, pids)) {
+        std::fprintf(stderr, "cannot list /proc\n");
+        return 1;
+    }
+    close(proc_fd);
+
+    // Строки снимаются один раз: оба парсера разбирают одни и те же данные
+    std::vector<std::string> lines;
+    std::vector<std::string> paths;
+    char buf[1024];
+    char path[64];
+    for (int pid : pids) {
+        if (!formatProcPath(path, sizeof(path), pid, "stat")) continue;
+        ssize_t len = readProcFile(path, buf, sizeof(buf));
+        if (len <= 0) continue;
+        lines.emplace_back(buf, static_cast<size_t>(len));
+        paths.emplace_back(path);
+    }
+    if (lines.empty()) {
+        std::fprintf(stderr, "no readable /proc/PID/stat\n");
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    size_t items = lines.size() * static_cast<size_t>(rounds);
+    uint64_t sink = 0;
+    Parsed parsed;
+    std::string name;
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& line : lines) {
+            if (parseOld(line, name, parsed)) sink += parsed.rss + name.size();
+        }
+    }
+    double old_parse = nsPerItem(Clock::now() - start, items);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& line : lines) {
+            if (parseNew(line.data(), line.size(), parsed)) sink += parsed.rss + static_cast<uint64_t>(parsed.ppid);
+        }
+    }
+    double new_parse = nsPerItem(Clock::now() - start, items);
+
+    // С чтением файла: ifstream + getline против open/read/close в буфер на стеке.
+    // Процессы могли завершиться - такие просто не разбираются
+    int read_rounds = std::max(1, rounds / 10);
+    size_t read_items = paths.size() * static_cast<size_t>(read_rounds);
+
+    start = Clock::now();
+    for (int r = 0; r < read_rounds; ++r) {
+        for (const auto& p : paths) {
+            std::ifstream file(p);
+            std::string line;
+            if (std::getline(file, line) && parseOld(line, name, parsed)) sink += parsed.rss;
+        }
+    }
+    double old_read = nsPerItem(Clock::now() - start, read_items);
+
+    start = Clock::now();
+    for (int r = 0; r < read_rounds; ++r) {
+        for (const auto& p : paths) {
+            ssize_t len = readProcFile(p.c_str(), buf, sizeof(buf));
+            if (len > 0 && parseNew(buf, static_cast<size_t>(len), parsed)) sink += parsed.rss;
+        }
+    }
+    double new_read = nsPerItem(Clock::now() - start, read_items);
+
+    std::printf("%zu processes, %d rounds (%d with reads)\n", lines.size(), rounds, read_rounds);
+    std::printf("parse only:  istringstream %8.0f ns/proc   parseProcStat %8.0f ns/proc   %.1fx\n",
+                old_parse, new_parse, old_parse / new_parse);
+    std::printf("read+parse:  ifstream      %8.0f ns/proc   readProcFile  %8.0f ns/proc   %.1fx\n",
+                old_read, new_read, old_read / new_read);
+    result_sink = sink;
+    return 0;
+}
@@ -61,15 +61,33 @@ bool ConfigParser::saveConfig(const std::string& config_path) const {
     file << "show_memory_bar = " << (config.show_memory_bar ? "true" : "false") << "\n";
     file << "header = " << (config.header ? "true" : "false") << "\n";
     file << "show_cpu_bar = " << (config.show_cpu_bar ? "true" : "false") << "\n";
+    file << "show_cpu_cores = " << (config.show_cpu_cores ? "true" : "false") << "\n";
+    file << "stacked_cpu_bar = " << (config.stacked_cpu_bar ? "true" : "false") << "\n";
+    file << "show_memory_detail = " << (config.show_memory_detail ? "true" : "false") << "\n";
+    file << "show_pressure = " << (config.show_pressure ? "true" : "false") << "\n";
     file << "progress_bar_width = " << config.progress_bar_width << "\n";
     file << "theme = " << config.theme << "\n\n";
     
     file << "[processes]\n";
     file << "sort_by = " << sortByToString(config.sort_by) << "\n";
     file << "reverse_sort = " << (config.reverse_sort ? "true" : "false") << "\n";
+    file << "group_by = " << groupByToString(config.group_by) << "\n";
+    file << "tree_view = " << (config.tree_view ? "true" : "false") << "\n";
+    file << "show_threads = " << (config.show_threads ? "true" : "false") << "\n";
+    file << "max_threads = " << config.max_threads << "\n";
+    file << "memory_accounting = " << memoryAccountingToString(config.memory_accounting) << "\n";
+    file << "smaps_max_age = " << config.smaps_max_age << "\n";
+    file << "smaps_reads_per_tick = " << config.smaps_reads_per_tick << "\n";
     file << "show_process_state = " << (config.show_process_state ? "true" : "false") << "\n";
     file << "show_process_user = " << (config.show_process_user ? "true" : "false") << "\n";
+    file << "show_process_io = " << (config.show_process_io ? "true" : "false") << "\n";
     file << "show_kernel_threads = " << (config.show_kernel_threads ? "true" : "false") << "\n";
+    file << "user_cache_ttl = " << config.user_cache_ttl << "\n";
+    file << "collector_threads = " << config.collector_threads << "\n";
+    file << "collector = " << collectorToString(config.collector) << "\n";
+    file << "idle_backoff_ticks = " << config.idle_backoff_ticks << "\n";
+    file << "proc_events = " << (config.proc_events ? "true" : "false") << "\n";
+    file << "short_lived_list = " << config.short_lived_list << "\n";
     
     if (!config.hide_processes.empty()) {
         file << "hide_processes = ";
@@ -80,6 +98,15 @@ bool ConfigParser::saveConfig(const std::string& config_path) const {
         file << "\n";
     }
     
+    if (!config.filters.empty()) {
+        file << "filters = ";
+        for (size_t i = 0; i < config.filters.size(); ++i) {
+            if (i > 0) file << ",";
+            file << config.filters[i];
+        }
+        file << "\n";
+    }
+    
     if (!config.show_only_users.empty()) {
         file << "show_only_users = ";
         for (size_t i = 0; i < config.show_only_users.size(); ++i) {
@@ -115,10 +142,10 @@ bool ConfigParser::parseCommandLine(int argc, char* argv[]) {
                 return false;
             }
         } else if (arg == "-d" || arg == "--delay") {
-            if (i + 1 < argc) {
-                config.update_interval = parseInt(argv[++i]);
+            if (i + 1 < argc && parseInterval(argv[i + 1], config.update_interval)) {
+                ++i;
             } else {
-                std::cerr << "Error: --delay requires a number\n";
+                std::cerr << "Error: --delay requires a positive number of seconds\n";
                 return false;
             }
         } else if (arg == "-n" || arg == "--max-processes") {
@@ -128,6 +155,108 @@ bool ConfigParser::parseCommandLine(int argc, char* argv[]) {
                 std::cerr << "Error: --max-processes requires a number\n";
                 return false;
             }
+        } else if (arg == "-b" || arg == "--batch") {
+            config.batch_mode = true;
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc && parseOutputFormat(argv[i + 1], config.output_format)) {
+                config.batch_mode = true;
+                ++i;
+            } else {
+                std::cerr << "Error: --output requires json or csv\n";
+                return false;
+            }
+        } else if (arg == "--output-file") {
+            if (i + 1 < argc) {
+                config.output_file = argv[++i];
+                config.batch_mode = true;
+            } else {
+                std::cerr << "Error: --output-file requires a file path\n";
+                return false;
+            }
+        } else if (arg == "-i" || arg == "--iterations") {
+            if (i + 1 < argc) {
+                config.iterations = parseInt(argv[++i]);
+            } else {
+                std::cerr << "Error: --iterations requires a number\n";
+                return false;
+            }
+        } else if (arg == "--record") {
+            if (i + 1 < argc) {
+                config.record_file = argv[++i];
+            } else {
+                std::cerr << "Error: --record requires a file path\n";
+                return false;
+            }
+        } else if (arg == "--replay") {
+            if (i + 1 < argc) {
+                config.replay_file = argv[++i];
+            } else {
+                std::cerr << "Error: --replay requires a file path\n";
+                return false;
+            }
+        } else if (arg == "--replay-speed") {
+            if (i + 1 < argc) {
+                config.replay_speed = parseDouble(argv[++i]);
+            } else {
+                std::cerr << "Error: --replay-speed requires a number\n";
+                return false;
+            }
+        } else if (arg == "--replay-seek") {
+            if (i + 1 < argc) {
+                config.replay_seek = parseDouble(argv[++i]);
+            } else {
+                std::cerr << "Error: --replay-seek requires a number of seconds\n";
+                return false;
+            }
+        } else if (arg == "-f" || arg == "--filter") {
+            if (i + 1 < argc) {
+                config.name_filter = argv[++i];
+            } else {
+                std::cerr << "Error: --filter requires a text\n";
+                return false;
+            }
+        } else if (arg == "-w" || arg == "--where") {
+            if (i + 1 < argc) {
+                config.filters.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: --where requires an expression such as cpu>5\n";
+                return false;
+            }
+        } else if (arg == "--collector") {
+            if (i + 1 < argc && parseCollector(argv[i + 1], config.collector)) {
+                ++i;
+            } else {
+                std::cerr << "Error: --collector requires procfs, taskstats or auto\n";
+                return false;
+            }
+        } else if (arg == "--group-by") {
+            if (i + 1 < argc && parseGroupBy(argv[i + 1], config.group_by)) {
+                ++i;
+            } else {
+                std::cerr << "Error: --group-by requires none or cgroup\n";
+                return false;
+            }
+        } else if (arg == "--tree") {
+            config.tree_view = true;
+        } else if (arg == "--threads") {
+            config.show_threads = true;
+        } else if (arg == "--memory") {
+            if (i + 1 < argc && parseMemoryAccounting(argv[i + 1], config.memory_accounting)) {
+                ++i;
+            } else {
+                std::cerr << "Error: --memory requires rss or pss\n";
+                return false;
+            }
+        } else if (arg == "--proc-events") {
+            config.proc_events = true;
+        } else if (arg == "--short-lived") {
+            if (i + 1 < argc) {
+                config.proc_events = true;
+                config.short_lived_list = std::max(0, parseInt(argv[++i]));
+            } else {
+                std::cerr << "Error: --short-lived requires a number\n";
+                return false;
+            }
         } else if (arg == "--sort-memory") {
             config.sort_by = MtopConfig::SortBy::MEMORY;
         } else if (arg == "--sort-cpu") {
@@ -138,6 +267,8 @@ bool ConfigParser::parseCommandLine(int argc, char* argv[]) {
             config.sort_by = MtopConfig::SortBy::PID;
         } else if (arg == "--sort-name") {
             config.sort_by = MtopConfig::SortBy::NAME;
+        } else if (arg == "--sort-io") {
+            config.sort_by = MtopConfig::SortBy::IO;
         } else if (arg == "--reverse") {
             config.reverse_sort = true;
         } else {
@@ -154,13 +285,51 @@ void ConfigParser::printHelp() const {
     std::cout << "Options:\n";
     std::cout << "  -h, --help              Show this help message\n";
     std::cout << "  -c, --config FILE       Use specified configuration file\n";
-    std::cout << "  -d, --delay SECONDS     Update interval in seconds\n";
-    std::cout << "  -n, --max-processes N   Maximum number of processes to show\n";
+    std::cout << "  -d, --delay SECONDS     Update interval in seconds, e.g. 0.25 (min 0.01)\n";
+    std::cout << "  -n, --max-processes N   Maximum number of processes to show (0 = all)\n";
     std::cout << "  --sort-memory           Sort processes by memory usage (default)\n";
     std::cout << "  --sort-cpu              Sort processes by CPU usage\n";
     std::cout << "  --sort-pid              Sort processes by PID\n";
     std::cout << "  --sort-name             Sort processes by name\n";
-    std::cout << "  --reverse               Reverse sort order\n\n";
+    std::cout << "  --sort-io               Sort processes by disk read + write rate\n";
+    std::cout << "  --reverse               Reverse sort order\n";
+    std::cout << "  -f, --filter TEXT       Show only processes whose name contains TEXT\n";
+    std::cout << "  -w, --where EXPR        Show only processes matching EXPR, repeatable:\n";
+    std::cout << "                          cpu>5, mem>=1G, state=D, pid, ppid, threads,\n";
+    std::cout << "                          user!=root (< <= > >= = !=)\n";
+    std::cout << "  --group-by cgroup       Aggregate processes by cgroup v2 (none = off)\n";
+    std::cout << "  --tree                  Show processes as a tree with subtree totals\n";
+    std::cout << "  --threads               List the busiest threads under each process\n";
+    std::cout << "  --memory pss            Show PSS (USS, swap in JSON) from smaps_rollup\n";
+    std::cout << "                          for the shown rows instead of RSS\n";
+    std::cout << "  --collector NAME        Process data source: procfs (default), taskstats\n";
+    std::cout << "                          (netlink, root; shows peak RSS) or auto\n";
+    std::cout << "  --proc-events           Track processes via the netlink proc connector (root)\n";
+    std::cout << "  --short-lived N         With --proc-events, list up to N processes that\n";
+    std::cout << "                          started and exited within one interval\n\n";
+    std::cout << "Keys:\n";
+    std::cout << "  c m p n i               Sort by CPU, memory, PID, name, disk I/O\n";
+    std::cout << "  r                       Reverse sort order\n";
+    std::cout << "  g                       Toggle grouping by cgroup\n";
+    std::cout << "  T                       Toggle the process tree\n";
+    std::cout << "  t                       Toggle thread rows\n";
+    std::cout << "  Left Right              Collapse / expand the threads of the selection\n";
+    std::cout << "  /                       Edit the name filter or an expression such as\n";
+    std::cout << "                          mem>1G (Enter keeps it, Esc clears)\n";
+    std::cout << "  space                   Pause / resume the display\n";
+    std::cout << "  Up Down PgUp PgDn       Select a process\n";
+    std::cout << "  k K                     Send SIGTERM / SIGKILL to the selection\n";
+    std::cout << "  q                       Quit\n\n";
+    std::cout << "Batch mode:\n";
+    std::cout << "  -b, --batch             Write samples to stdout instead of the terminal UI\n";
+    std::cout << "  -o, --output FORMAT     Output format: json (JSON Lines, default) or csv\n";
+    std::cout << "  --output-file FILE      Append samples to FILE instead of stdout\n";
+    std::cout << "  -i, --iterations N      Stop after N samples (0 = until interrupted)\n\n";
+    std::cout << "Recording:\n";
+    std::cout << "  --record FILE           Append every sample to a binary session log\n";
+    std::cout << "  --replay FILE           Play a recorded session instead of live data\n";
+    std::cout << "  --replay-speed X        Replay speed multiplier (default 1.0)\n";
+    std::cout << "  --replay-seek SECONDS   Start replay SECONDS after the recording start\n\n";
     std::cout << "Configuration files:\n";
     std::cout << "  ~/.config/mtop/config   User configuration\n";
     std::cout << "  /etc/mtop/config        System configuration\n\n";
@@ -216,7 +385,7 @@ bool ConfigParser::parseLine(const std::string& line) {
     
     // Parse configuration values
     if (key == "update_interval") {
-        config.update_interval = parseInt(value);
+        return parseInterval(value, config.update_interval);
     } else if (key == "max_processes") {
         config.max_processes = parseInt(value);
     } else if (key == "show_load_avg") {
@@ -225,6 +394,14 @@ bool ConfigParser::parseLine(const std::string& line) {
         config.show_memory_bar = parseBool(value);
     } else if (key == "show_cpu_bar") {
         config.show_cpu_bar = parseBool(value);
+    } else if (key == "show_cpu_cores") {
+        config.show_cpu_cores = parseBool(value);
+    } else if (key == "stacked_cpu_bar") {
+        config.stacked_cpu_bar = parseBool(value);
+    } else if (key == "show_memory_detail") {
+        config.show_memory_detail = parseBool(value);
+    } else if (key == "show_pressure") {
+        config.show_pressure = parseBool(value);
     } else if (key == "progress_bar_width") {
         config.progress_bar_width = parseInt(value);
     } else if (key == "theme") {
@@ -233,20 +410,53 @@ bool ConfigParser::parseLine(const std::string& line) {
         config.sort_by = parseSortBy(value);
     } else if (key == "reverse_sort") {
         config.reverse_sort = parseBool(value);
+    } else if (key == "group_by") {
+        return parseGroupBy(value, config.group_by);
+    } else if (key == "tree_view") {
+        config.tree_view = parseBool(value);
+    } else if (key == "show_threads") {
+        config.show_threads = parseBool(value);
+    } else if (key == "max_threads") {
+        config.max_threads = std::max(0, parseInt(value));
+    } else if (key == "memory_accounting") {
+        return parseMemoryAccounting(value, config.memory_accounting);
+    } else if (key == "smaps_max_age") {
+        config.smaps_max_age = std::max(0.0, parseDouble(value));
+    } else if (key == "smaps_reads_per_tick") {
+        config.smaps_reads_per_tick = std::max(0, parseInt(value));
     } else if (key == "header") {
         config.header = parseBool(value);
     } else if (key == "show_process_state") {
         config.show_process_state = parseBool(value);
     } else if (key == "show_process_user") {
         config.show_process_user = parseBool(value);
+    } else if (key == "show_process_io") {
+        config.show_process_io = parseBool(value);
     } else if (key == "show_kernel_threads") {
         config.show_kernel_threads = parseBool(value);
+    } else if (key == "user_cache_ttl") {
+        config.user_cache_ttl = parseInt(value);
+    } else if (key == "collector_threads") {
+        config.collector_threads = parseInt(value);
+    } else if (key == "collector") {
+        return parseCollector(value, config.collector);
+    } else if (key == "idle_backoff_ticks") {
+        config.idle_backoff_ticks = std::max(0, parseInt(value));
+    } else if (key == "proc_events") {
+        config.proc_events = parseBool(value);
+    } else if (key == "short_lived_list") {
+        config.short_lived_list = std::max(0, parseInt(value));
     } else if (key == "hide_processes") {
         config.hide_processes = split(value, ',');
         // Trim each process name
         for (auto& proc : config.hide_processes) {
             proc = trim(proc);
         }
+    } else if (key == "filters") {
+        config.filters = split(value, ',');
+        for (auto& filter : config.filters) {
+            filter = trim(filter);
+        }
     } else if (key == "show_only_users") {
         config.show_only_users = split(value, ',');
         // Trim each username
@@ -295,6 +505,25 @@ int ConfigParser::parseInt(const std::string& value) const {
     }
 }
 
+double ConfigParser::parseDouble(const std::string& value) const {
+    try {
+        return std::stod(value);
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+bool ConfigParser::parseInterval(const std::string& value, double& interval) const {
+    double seconds = parseDouble(value);
+    if (!(seconds > 0.0)) {
+        return false;
+    }
+    
+    // Below 10 ms a scan cannot finish in time; cap at one day
+    interval = std::clamp(seconds, 0.01, 86400.0);
+    return true;
+}
+
 MtopConfig::SortBy ConfigParser::parseSortBy(const std::string& value) const {
     std::string lower_value = value;
     std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
@@ -302,15 +531,94 @@ MtopConfig::SortBy ConfigParser::parseSortBy(const std::string& value) const {
     if (lower_value == "cpu") return MtopConfig::SortBy::CPU;
     if (lower_value == "pid") return MtopConfig::SortBy::PID;
     if (lower_value == "name") return MtopConfig::SortBy::NAME;
+    if (lower_value == "io") return MtopConfig::SortBy::IO;
     
     return MtopConfig::SortBy::MEMORY; // Default
 }
 
+bool ConfigParser::parseOutputFormat(const std::string& value, MtopConfig::OutputFormat& format) const {
+    std::string lower_value = value;
+    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+    
+    if (lower_value == "json" || lower_value == "jsonl") {
+        format = MtopConfig::OutputFormat::JSON;
+        return true;
+    }
+    if (lower_value == "csv") {
+        format = MtopConfig::OutputFormat::CSV;
+        return true;
+    }
+    
+    return false;
+}
+
+bool ConfigParser::parseCollector(const std::string& value, MtopConfig::Collector& collector) const {
+    std::string lower_value = value;
+    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+    
+    if (lower_value == "procfs") {
+        collector = MtopConfig::Collector::PROCFS;
+    } else if (lower_value == "taskstats") {
+        collector = MtopConfig::Collector::TASKSTATS;
+    } else if (lower_value == "auto") {
+        collector = MtopConfig::Collector::AUTO;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string ConfigParser::collectorToString(MtopConfig::Collector collector) const {
+    switch (collector) {
+        case MtopConfig::Collector::TASKSTATS: return "taskstats";
+        case MtopConfig::Collector::AUTO: return "auto";
+        case MtopConfig::Collector::PROCFS: return "procfs";
+    }
+    return "procfs";
+}
+
+bool ConfigParser::parseGroupBy(const std::string& value, MtopConfig::GroupBy& group_by) const {
+    std::string lower_value = value;
+    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+    
+    if (lower_value == "none" || lower_value == "process") {
+        group_by = MtopConfig::GroupBy::NONE;
+    } else if (lower_value == "cgroup") {
+        group_by = MtopConfig::GroupBy::CGROUP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string ConfigParser::groupByToString(MtopConfig::GroupBy group_by) const {
+    return group_by == MtopConfig::GroupBy::CGROUP ? "cgroup" : "none";
+}
+
+bool ConfigParser::parseMemoryAccounting(const std::string& value, MtopConfig::MemoryAccounting& accounting) const {
+    std::string lower_value = value;
+    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(), ::tolower);
+    
+    if (lower_value == "rss") {
+        accounting = MtopConfig::MemoryAccounting::RSS;
+    } else if (lower_value == "pss") {
+        accounting = MtopConfig::MemoryAccounting::PSS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string ConfigParser::memoryAccountingToString(MtopConfig::MemoryAccounting accounting) const {
+    return accounting == MtopConfig::MemoryAccounting::PSS ? "pss" : "rss";
+}
+
 std::string ConfigParser::sortByToString(MtopConfig::SortBy sort_by) const {
     switch (sort_by) {
         case MtopConfig::SortBy::CPU: return "cpu";
         case MtopConfig::SortBy::PID: return "pid";
         case MtopConfig::SortBy::NAME: return "name";
+        case MtopConfig::SortBy::IO: return "io";
         case MtopConfig::SortBy::MEMORY: return "memory";
     }
     return "memory";
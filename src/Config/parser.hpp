@@ -7,11 +7,15 @@
 
 struct MtopConfig {
     // Display settings
-    int update_interval = 2;
+    double update_interval = 2.0; // seconds, fractions allowed
     int max_processes = 20;
     bool show_load_avg = true;
     bool show_memory_bar = true;
     bool show_cpu_bar = true;
+    bool show_cpu_cores = true; // per-core heat strip under the CPU bar
+    bool stacked_cpu_bar = false; // CPU bar split into user/system/irq/steal/... segments
+    bool show_memory_detail = true; // buffers, cache, slab, dirty, swap line
+    bool show_pressure = true;      // PSI panel, if the kernel has /proc/pressure
     bool header = true;
     
     // Process settings
@@ -19,21 +23,96 @@ struct MtopConfig {
         MEMORY,
         CPU,
         PID,
-        NAME
+        NAME,
+        IO    // storage bytes per second from /proc/PID/io
     };
     SortBy sort_by = SortBy::MEMORY;
     bool reverse_sort = false;
     
+    // Rows of the process table: processes, or cgroup v2 groups with their
+    // processes aggregated (sorted by CPU, memory, process count or path)
+    enum class GroupBy {
+        NONE,
+        CGROUP
+    };
+    GroupBy group_by = GroupBy::NONE;
+    
+    // Process rows as a parent/child tree; siblings are ordered by their
+    // subtree totals of memory and CPU
+    bool tree_view = false;
+    
+    // Thread rows under each shown process: its busiest max_threads threads
+    // (0 = all) with their own CPU% and state, from /proc/PID/task
+    bool show_threads = false;
+    int max_threads = 10;
+    
+    // Memory of each shown process: RSS, or PSS/USS/swap from
+    // /proc/PID/smaps_rollup. smaps walks every mapping of the process, so it
+    // is read only for the selected rows, a row is re-read once it is older
+    // than smaps_max_age seconds, and at most smaps_reads_per_tick per tick
+    enum class MemoryAccounting {
+        RSS,
+        PSS
+    };
+    MemoryAccounting memory_accounting = MemoryAccounting::RSS;
+    double smaps_max_age = 5.0;
+    int smaps_reads_per_tick = 16; // 0 = no limit
+    
     // UI settings
     std::string theme = "default";
     int progress_bar_width = 30;
     bool show_process_state = true;
     bool show_process_user = true;
+    bool show_process_io = true; // disk read/write rate column of the shown rows
     
-    // Filtering
+    // Filtering. hide_processes entries are name substrings, or shell globs
+    // against the whole name when they contain * ? or [
     std::vector<std::string> hide_processes;
     std::vector<std::string> show_only_users;
     bool show_kernel_threads = false;
+    std::string name_filter; // case-insensitive substring or one expression, empty = off
+    std::vector<std::string> filters; // all must hold: cpu>5, mem>1G, state=D, user=root...
+    
+    // Batch output (headless mode, no Display)
+    enum class OutputFormat {
+        JSON,
+        CSV
+    };
+    bool batch_mode = false;
+    OutputFormat output_format = OutputFormat::JSON;
+    std::string output_file;  // empty = stdout
+    int iterations = 0;       // 0 = run until interrupted
+    
+    // Session recording and replay
+    std::string record_file;
+    std::string replay_file;
+    double replay_speed = 1.0;
+    double replay_seek = 0.0; // seconds from the start of the recording
+    
+    // Threads scanning /proc (1 = single-threaded, 0 = auto)
+    int collector_threads = 1;
+    
+    // Per-process data source: /proc/PID/stat text, taskstats netlink
+    // queries (needs CAP_NET_ADMIN), or taskstats when available
+    enum class Collector {
+        PROCFS,
+        TASKSTATS,
+        AUTO
+    };
+    Collector collector = Collector::PROCFS;
+    
+    // After this many reads with no CPU or RSS change a process is re-read
+    // only every this many ticks (0 = read every process every tick)
+    int idle_backoff_ticks = 0;
+    
+    // Track PIDs with the netlink proc connector (needs CAP_NET_ADMIN,
+    // falls back to listing /proc) and report processes that lived less
+    // than one interval; short_lived_list caps how many are listed by name
+    bool proc_events = false;
+    int short_lived_list = 0;
+    
+    // Seconds before cached user names are re-resolved (0 = only on /etc/passwd change)
+    int user_cache_ttl = 300;
 };
 
 class ConfigParser {
@@ -81,8 +160,17 @@ private:
     // Value parsing
     bool parseBool(const std::string& value) const;
     int parseInt(const std::string& value) const;
+    double parseDouble(const std::string& value) const;
+    bool parseInterval(const std::string& value, double& interval) const;
     MtopConfig::SortBy parseSortBy(const std::string& value) const;
     std::string sortByToString(MtopConfig::SortBy sort_by) const;
+    bool parseOutputFormat(const std::string& value, MtopConfig::OutputFormat& format) const;
+    bool parseCollector(const std::string& value, MtopConfig::Collector& collector) const;
+    std::string collectorToString(MtopConfig::Collector collector) const;
+    bool parseGroupBy(const std::string& value, MtopConfig::GroupBy& group_by) const;
+    std::string groupByToString(MtopConfig::GroupBy group_by) const;
+    bool parseMemoryAccounting(const std::string& value, MtopConfig::MemoryAccounting& accounting) const;
+    std::string memoryAccountingToString(MtopConfig::MemoryAccounting accounting) const;
 };
 
 #endif // CONFIG_PARSER_HPP
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "cgroup.hpp"
+#include "proc_file.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Раскрывает восьмеричные escape-последовательности mountinfo: ядро
+// экранирует пробел, табуляцию, перевод строки и обратную косую черту (\040, \011, \012, \134)
+std::string unescapeMountField(std::string_view field) {
+    std::string out;
+    out.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] == '\\' && i + 3 < field.size() &&
+            field[i + 1] >= '0' && field[i + 1] <= '3' &&
+            field[i + 2] >= '0' && field[i + 2] <= '7' &&
+            field[i + 3] >= '0' && field[i + 3] <= '7') {
+            out += static_cast<char>((field[i + 1] - '0') * 64 + (field[i + 2] - '0') * 8 + (field[i + 3] - '0'));
+            i += 3;
+        } else {
+            out += field[i];
+        }
+    }
+    return out;
+}
+
+// Ищет точку монтирования cgroup2 в /proc/self/mountinfo:
+// "ID PARENT MAJ:MIN ROOT MOUNT_POINT OPTIONS ... - FSTYPE SOURCE SUPER_OPTIONS"
+std::string findCgroup2Mount() {
+    ProcFile mountinfo("/proc/self/mountinfo");
+    std::vector<char> buf;
+    ssize_t len = mountinfo.read(buf);
+    if (len <= 0) return std::string();
+
+    const char* p = buf.data();
+    const char* end = p + len;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        std::string_view line(p, static_cast<size_t>(eol - p));
+        p = eol + 1;
+
+        if (line.find(" - cgroup2 ") == std::string_view::npos) continue;
+
+        // Пятое поле - точка монтирования (пробелы в ней экранированы как \040)
+        size_t pos = 0;
+        for (int field = 0; field < 4 && pos != std::string_view::npos; ++field) {
+            pos = line.find(' ', pos);
+            if (pos != std::string_view::npos) pos++;
+        }
+        if (pos == std::string_view::npos) continue;
+        size_t space = line.find(' ', pos);
+        if (space == std::string_view::npos) continue;
+        return unescapeMountField(line.substr(pos, space - pos));
+    }
+    return std::string();
+}
+
+// Файл группы относительно точки монтирования: "/a/b" -> "a/b/cpu.stat"
+int openGroupFile(int root_fd, const std::string& path, const char* file) {
+    std::string relative = path.size() > 1 ? path.substr(1) + "/" + file : std::string(file);
+    return openat(root_fd, relative.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+ssize_t readGroupFile(int fd, char* buf, size_t size) {
+    return fd >= 0 ? preadFile(fd, buf, size) : -1;
+}
+
+} // namespace
+
+CgroupMonitor::Group::~Group() {
+    for (int fd : {cpu_fd, memory_fd, pressure_fd}) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+CgroupMonitor::CgroupMonitor() : root_fd(-1) {
+    std::string mount = findCgroup2Mount();
+    if (!mount.empty()) {
+        root_fd = ::open(mount.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+}
+
+CgroupMonitor::~CgroupMonitor() {
+    groups.clear();
+    if (root_fd >= 0) {
+        close(root_fd);
+    }
+}
+
+bool CgroupMonitor::readProcessCgroup(int pid, std::string& path) {
+    char file_path[64];
+    char buf[4096];
+    if (!formatProcPath(file_path, sizeof(file_path), pid, "cgroup")) return false;
+
+    ssize_t len = readProcFile(file_path, buf, sizeof(buf));
+    std::string_view cgroup;
+    if (len <= 0 || !parseProcCgroup(buf, static_cast<size_t>(len), cgroup)) return false;
+
+    // Обычно путь не меняется - не трогаем строку, чтобы не аллоцировать
+    if (path != cgroup) {
+        path.assign(cgroup.data(), cgroup.size());
+    }
+    return true;
+}
+
+CgroupMonitor::Group& CgroupMonitor::touch(const std::string& path, uint64_t tick) {
+    Group& group = groups.try_emplace(path).first->second;
+    if (group.seen_tick == 0) {
+        group.info.path = path;
+    }
+    group.seen_tick = tick;
+    return group;
+}
+
+void CgroupMonitor::refresh(uint64_t tick) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = groups.begin(); it != groups.end();) {
+        // Группа без процессов (удалена или опустела) - закрываем ее файлы
+        if (it->second.seen_tick != tick) {
+            it = groups.erase(it);
+            continue;
+        }
+        if (!it->second.opened) {
+            open(it->first, it->second);
+        }
+        read(it->second, now);
+        ++it;
+    }
+}
+
+void CgroupMonitor::open(const std::string& path, Group& group) {
+    group.opened = true;
+    if (root_fd < 0) return;
+
+    // cpu.stat корня - время всей системы, а не его собственных процессов;
+    // memory.current в корне нет. Для корня остаются суммы по процессам,
+    // как и для групп без контроллера memory
+    if (path != "/") {
+        group.cpu_fd = openGroupFile(root_fd, path, "cpu.stat");
+        group.memory_fd = openGroupFile(root_fd, path, "memory.current");
+    }
+    group.pressure_fd = openGroupFile(root_fd, path, "memory.pressure");
+}
+
+void CgroupMonitor::read(Group& group, std::chrono::steady_clock::time_point now) {
+    char buf[1024];
+
+    // CPU% группы - прирост usage_usec за интервал, 100% - одно ядро, как у процессов
+    uint64_t usage = 0;
+    ssize_t len = readGroupFile(group.cpu_fd, buf, sizeof(buf));
+    bool cpu_ok = len > 0 && parseCgroupCpuStat(buf, static_cast<size_t>(len), usage);
+    group.has_cpu = false;
+    if (cpu_ok && group.prev_usage_usec > 0 && usage >= group.prev_usage_usec) {
+        double elapsed_us = std::chrono::duration<double, std::micro>(now - group.prev_time).count();
+        if (elapsed_us > 0.0) {
+            group.cgroup_cpu = 100.0 * static_cast<double>(usage - group.prev_usage_usec) / elapsed_us;
+            group.has_cpu = true;
+        }
+    }
+    group.prev_usage_usec = cpu_ok ? usage : 0;
+    group.prev_time = now;
+
+    // memory.current - байты, включая page cache группы
+    len = readGroupFile(group.memory_fd, buf, sizeof(buf));
+    uint64_t bytes = 0;
+    group.has_memory = len > 0 && parseNextNumber(buf, buf + len, bytes) != nullptr;
+    group.cgroup_memory_kb = bytes / 1024;
+
+    len = readGroupFile(group.pressure_fd, buf, sizeof(buf));
+    group.info.has_pressure = len > 0 && parsePressure(buf, static_cast<size_t>(len), group.info.memory_pressure);
+}
+
+void CgroupMonitor::resetSums() {
+    for (auto& entry : groups) {
+        Group& group = entry.second;
+        group.info.process_count = 0;
+        group.info.rss_kb = 0;
+        group.process_cpu = 0.0;
+    }
+}
+
+void CgroupMonitor::collect(std::vector<CgroupInfo>& out) const {
+    out.clear();
+    for (const auto& entry : groups) {
+        const Group& group = entry.second;
+        if (group.info.process_count == 0) continue;
+
+        out.push_back(group.info);
+        CgroupInfo& info = out.back();
+        info.cpu_percent = group.has_cpu ? group.cgroup_cpu : group.process_cpu;
+        info.memory_kb = group.has_memory ? group.cgroup_memory_kb : group.info.rss_kb;
+    }
+}
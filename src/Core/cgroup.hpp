@@ -0,0 +1,90 @@
+#ifndef CGROUP_HPP
+#define CGROUP_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "proc_parser.hpp"
+
+// One cgroup v2 directory in the grouped view. cpu_percent and memory_kb
+// come from the cgroup's own cpu.stat and memory.current when they exist,
+// so exited children and all threads are counted; otherwise they fall back
+// to the sums over its visible processes.
+struct CgroupInfo {
+    std::string path;  // relative to the cgroup2 mount, "/" is the root
+    int process_count = 0;
+    double cpu_percent = 0.0;
+    uint64_t memory_kb = 0;
+    uint64_t rss_kb = 0;        // sum of the processes' RSS
+    bool has_pressure = false;  // memory.pressure exists
+    PressureInfo memory_pressure;
+};
+
+// Tracks the cgroups that own the scanned processes. The cgroup2 hierarchy
+// is found in /proc/self/mountinfo (/sys/fs/cgroup, or .../unified on
+// hybrid hosts). Each group keeps its cpu.stat, memory.current and
+// memory.pressure open and re-reads them with pread() once per tick.
+class CgroupMonitor {
+public:
+    struct Group {
+        Group() = default;
+        ~Group();
+        Group(const Group&) = delete;
+        Group& operator=(const Group&) = delete;
+
+        CgroupInfo info;
+        uint64_t seen_tick = 0;
+        bool opened = false;
+        int cpu_fd = -1;
+        int memory_fd = -1;
+        int pressure_fd = -1;
+        uint64_t prev_usage_usec = 0;
+        std::chrono::steady_clock::time_point prev_time;
+
+        // From the cgroup files; false if a file is missing or unreadable
+        bool has_cpu = false;
+        bool has_memory = false;
+        double cgroup_cpu = 0.0;
+        uint64_t cgroup_memory_kb = 0;
+
+        double process_cpu = 0.0; // sum over the visible processes
+    };
+
+    CgroupMonitor();
+    ~CgroupMonitor();
+
+    CgroupMonitor(const CgroupMonitor&) = delete;
+    CgroupMonitor& operator=(const CgroupMonitor&) = delete;
+
+    bool available() const { return root_fd >= 0; }
+
+    // Reads the v2 path of a process from /proc/PID/cgroup. Thread-safe,
+    // called from the collector pool.
+    static bool readProcessCgroup(int pid, std::string& path);
+
+    // Returns the group of path, adding it if new, and marks it live for tick.
+    // References stay valid until the next refresh().
+    Group& touch(const std::string& path, uint64_t tick);
+
+    // Drops the groups not touched in tick, re-reads the files of the rest
+    void refresh(uint64_t tick);
+
+    // Zeroes the per-process sums (process_count, rss_kb, process_cpu)
+    void resetSums();
+
+    // Copies the groups with visible processes into out
+    void collect(std::vector<CgroupInfo>& out) const;
+
+    void clear() { groups.clear(); }
+
+private:
+    int root_fd; // the cgroup2 mount point
+    std::unordered_map<std::string, Group> groups;
+
+    void open(const std::string& path, Group& group);
+    void read(Group& group, std::chrono::steady_clock::time_point now);
+};
+
+#endif // CGROUP_HPP
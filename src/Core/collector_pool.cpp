@@ -0,0 +1,72 @@
+#include "collector_pool.hpp"
+
+CollectorPool::CollectorPool(size_t threads)
+    : current_job(nullptr), job_count(0), cursor(0), generation(0), busy(0), stopping(false) {
+    for (size_t i = 1; i < threads; ++i) {
+        helpers.emplace_back(&CollectorPool::workerLoop, this, i);
+    }
+}
+
+CollectorPool::~CollectorPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto& thread : helpers) {
+        thread.join();
+    }
+}
+
+void CollectorPool::run(size_t count, const Job& job) {
+    if (helpers.empty() || count <= chunk_size) {
+        // Параллелить нечего - выполняем в текущем потоке
+        if (count > 0) job(0, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current_job = &job;
+        job_count = count;
+        cursor.store(0, std::memory_order_relaxed);
+        busy = helpers.size();
+        generation++;
+    }
+    start_cv.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this] { return busy == 0; });
+    current_job = nullptr;
+}
+
+void CollectorPool::workerLoop(size_t index) {
+    uint64_t seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) return;
+            seen_generation = generation;
+        }
+
+        drain(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) {
+            done_cv.notify_one();
+        }
+    }
+}
+
+void CollectorPool::drain(size_t index) {
+    while (true) {
+        size_t begin = cursor.fetch_add(chunk_size, std::memory_order_relaxed);
+        if (begin >= job_count) break;
+        size_t end = begin + chunk_size < job_count ? begin + chunk_size : job_count;
+        (*current_job)(index, begin, end);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef COLLECTOR_POOL_HPP
+#define COLLECTOR_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small persistent worker pool for the /proc scan. run() splits [0, count)
+// into chunks that workers claim from a shared atomic cursor, so a worker
+// stuck on slow PIDs does not hold back the rest. The calling thread takes
+// part as worker 0 and run() returns once every chunk is done.
+class CollectorPool {
+public:
+    // job(worker_index, begin, end)
+    using Job = std::function<void(size_t, size_t, size_t)>;
+
+    explicit CollectorPool(size_t threads);
+    ~CollectorPool();
+
+    CollectorPool(const CollectorPool&) = delete;
+    CollectorPool& operator=(const CollectorPool&) = delete;
+
+    size_t size() const { return helpers.size() + 1; }
+
+    void run(size_t count, const Job& job);
+
+private:
+    static constexpr size_t chunk_size = 64;
+
+    std::vector<std::thread> helpers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+
+    const Job* current_job;
+    size_t job_count;
+    std::atomic<size_t> cursor;
+    uint64_t generation;
+    size_t busy;
+    bool stopping;
+
+    void workerLoop(size_t index);
+    void drain(size_t index);
+};
+
+#endif // COLLECTOR_POOL_HPP
@@ -0,0 +1,750 @@
+#include "display.hpp"
+#include <algorithm>
+#include <cstdio>
+
+Display::Display(const MtopConfig& cfg) : config(cfg), selected_pid(-1), first_row(0), page_rows(0) {
+}
+
+void Display::updateConfig(const MtopConfig& new_config) {
+    config = new_config;
+}
+
+void Display::setStatusLine(const std::string& text) {
+    status_line = text;
+}
+
+void Display::setSelectedPid(int pid) {
+    selected_pid = pid;
+}
+
+void Display::setThreadsCollapsed(int pid, bool collapsed) {
+    auto it = std::find(collapsed_pids.begin(), collapsed_pids.end(), pid);
+    if (collapsed && it == collapsed_pids.end()) {
+        collapsed_pids.push_back(pid);
+    } else if (!collapsed && it != collapsed_pids.end()) {
+        collapsed_pids.erase(it);
+    }
+}
+
+bool Display::isCollapsed(int pid) const {
+    return std::find(collapsed_pids.begin(), collapsed_pids.end(), pid) != collapsed_pids.end();
+}
+
+void Display::render(const SystemStats& stats) {
+    screen.beginFrame();
+
+    if (config.header) {
+        printHeader();
+    }
+    printSystemStats(stats);
+    if (stats.cgroup_view) {
+        printCgroups(stats);
+    } else {
+        printProcesses(stats);
+    }
+    printFooter();
+
+    screen.present();
+}
+
+void Display::printHeader() {
+    screen.setStyle("\033[1;36m"); // Яркий голубой
+    screen.print("╭───────────────────────────────────╮\n");
+    screen.print("│ ");
+    screen.setStyle("\033[1;35m");
+    screen.print("mtop 2");
+    screen.setStyle("\033[1;36m");
+    screen.print(" - Modern Top 2 by TheMomer │\n");
+    screen.print("╰───────────────────────────────────╯\n");
+    screen.resetStyle();
+}
+
+void Display::printSystemStats(const SystemStats& stats) {
+    char buf[64];
+
+    // CPU
+    snprintf(buf, sizeof(buf), "%.1f%%", stats.cpu_percent);
+    if (config.show_cpu_bar) {
+        screen.setStyle("\033[1m\033[93m");
+        screen.print("CPU: ");
+        if (config.stacked_cpu_bar) {
+            printStackedCpuBar(stats.cpu_breakdown, config.progress_bar_width);
+        } else {
+            printProgressBar(stats.cpu_percent, 100.0, config.progress_bar_width);
+        }
+        screen.print(" ");
+    } else {
+        screen.setStyle("\033[1;33m"); // Желтый для заголовков
+        screen.print("CPU: ");
+    }
+    screen.print(buf);
+    screen.newline();
+    printCpuBreakdown(stats);
+
+    if (config.show_cpu_cores && !stats.core_percent.empty()) {
+        printCoreStrip(stats.core_percent);
+    }
+
+    // Memory
+    double mem_percent = (static_cast<double>(stats.used_memory_kb) / stats.total_memory_kb) * 100.0;
+    snprintf(buf, sizeof(buf), "%.1f%% (%s/%s)", mem_percent,
+             formatBytes(stats.used_memory_kb * 1024).c_str(),
+             formatBytes(stats.total_memory_kb * 1024).c_str());
+    if (config.show_memory_bar) {
+        screen.setStyle("\033[1m\033[93m");
+        screen.print("MEM: ");
+        printProgressBar(mem_percent, 100.0, config.progress_bar_width);
+        screen.print(" ");
+    } else {
+        screen.setStyle("\033[1;33m");
+        screen.print("MEM: ");
+    }
+    screen.print(buf);
+    screen.newline();
+
+    if (config.show_memory_detail && stats.memory_detail.total_kb > 0) {
+        printMemoryDetail(stats.memory_detail);
+    }
+
+    // Load Average
+    if (config.show_load_avg) {
+        screen.setStyle("\033[1m\033[93m");
+        screen.print("Load: ");
+        screen.setStyle("\033[1;32m");
+        snprintf(buf, sizeof(buf), "%.2f %.2f %.2f", stats.load_avg[0], stats.load_avg[1], stats.load_avg[2]);
+        screen.print(buf);
+        screen.resetStyle();
+    } else {
+        screen.setStyle("\033[1;33m");
+    }
+
+    screen.print("  Processes: ");
+    screen.setStyle("\033[1;32m");
+    snprintf(buf, sizeof(buf), "%d", stats.process_count);
+    screen.print(buf);
+
+    // Активность ядра в секунду: переключения контекста, прерывания, fork()
+    screen.setStyle("\033[1;90m");
+    snprintf(buf, sizeof(buf), "  ctxt %s/s  intr %s/s  fork %s/s", formatRate(stats.context_switches_per_sec).c_str(),
+             formatRate(stats.interrupts_per_sec).c_str(), formatRate(stats.forks_per_sec).c_str());
+    screen.print(buf);
+
+    // Процессы, прожившие меньше интервала - видны только через proc connector
+    if (stats.proc_events) {
+        screen.setStyle("\033[1;33m");
+        screen.print("  Short-lived: ");
+        screen.setStyle(stats.short_lived_count > 0 ? "\033[1;31m" : "\033[1;32m");
+        snprintf(buf, sizeof(buf), "%d", stats.short_lived_count);
+        screen.print(buf);
+    }
+    screen.resetStyle();
+    screen.newline();
+
+    if (config.show_pressure && stats.pressure) {
+        printPressure(stats);
+    }
+
+    if (!stats.short_lived.empty()) {
+        screen.setStyle("\033[1;90m");
+        for (const auto& proc : stats.short_lived) {
+            snprintf(buf, sizeof(buf), " %d:", proc.pid);
+            screen.print(buf);
+            screen.print(proc.name.empty() ? "?" : proc.name);
+            snprintf(buf, sizeof(buf), "(%.0fms)", proc.lifetime_ms);
+            screen.print(buf);
+        }
+        screen.resetStyle();
+        screen.newline();
+    }
+    screen.newline();
+}
+
+void Display::printProcesses(const SystemStats& stats) {
+    char buf[32];
+
+    // Колонка диска добавляется справа, когда включена; в дереве вместо нее
+    // CPU% поддерева, а память - итог поддерева
+    bool tree = stats.tree_view;
+    bool io = config.show_process_io || tree;
+    screen.setStyle("\033[1;34m"); // Синий для заголовка таблицы
+    screen.print("╭─────────┬────────────────────┬─────────┬──────────────┬────────┬──────────────");
+    screen.print(io ? "┬──────────────╮\n" : "╮\n");
+    // taskstats не сообщает текущий RSS - колонка показывает пиковый
+    bool pss = config.memory_accounting == MtopConfig::MemoryAccounting::PSS;
+    screen.print(tree             ? "│   PID   │        NAME        │  STATE  │     USER     │  CPU%  │   TREE MEM   │"
+                 : pss              ? "│   PID   │        NAME        │  STATE  │     USER     │  CPU%  │     PSS      │"
+                 : stats.taskstats ? "│   PID   │        NAME        │  STATE  │     USER     │  CPU%  │   PEAK RSS   │"
+                                   : "│   PID   │        NAME        │  STATE  │     USER     │  CPU%  │    MEMORY    │");
+    screen.print(tree ? "  TREE CPU%   │\n" : io ? "   DISK R/W   │\n" : "\n");
+    screen.print("├─────────┼────────────────────┼─────────┼──────────────┼────────┼──────────────");
+    screen.print(io ? "┼──────────────┤\n" : "┤\n");
+
+    // Строки таблицы: процессы и под каждым его потоки, если он не свернут.
+    // Потоки в снимке сгруппированы по процессу подряд
+    rows.clear();
+    for (const ProcessInfo& proc : stats.processes) {
+        size_t begin = 0;
+        while (begin < stats.threads.size() && stats.threads[begin].tgid != proc.pid) begin++;
+        size_t end = begin;
+        while (end < stats.threads.size() && stats.threads[end].tgid == proc.pid) end++;
+
+        rows.push_back(TableRow{&proc, end > begin, {}, 0});
+        if (tree) {
+            rows.back().branch_width = formatBranch(proc, rows.back().branch);
+        }
+        if (!isCollapsed(proc.pid)) {
+            for (size_t i = begin; i < end; ++i) rows.push_back(TableRow{&stats.threads[i], false, {}, 0});
+        }
+    }
+
+    // Кадр не прокручивается: строк не больше, чем помещается над нижней рамкой и футером
+    int available = screen.rows() - screen.cursorRow() - 3;
+    page_rows = std::max(0, available);
+    size_t visible = std::min(rows.size(), static_cast<size_t>(page_rows));
+
+    // Прокрутка таблицы так, чтобы выбранная строка была видна
+    size_t selected = rows.size();
+    for (size_t i = 0; i < rows.size() && selected_pid >= 0; ++i) {
+        if (rows[i].info->tgid == 0 && rows[i].info->pid == selected_pid) {
+            selected = i;
+            break;
+        }
+    }
+    if (selected < rows.size()) {
+        if (selected < first_row) first_row = selected;
+        if (visible > 0 && selected >= first_row + visible) first_row = selected - visible + 1;
+    }
+    first_row = std::min(first_row, rows.size() - visible);
+
+    for (size_t i = first_row; i < first_row + visible; ++i) {
+        const ProcessInfo& proc = *rows[i].info;
+        if (proc.tgid != 0) {
+            printThreadRow(proc, io);
+            continue;
+        }
+
+        bool highlight = i == selected;
+        // Выбранная строка рисуется одним инверсным стилем поверх всех колонок
+        auto style = [&](const char* sgr) {
+            screen.setStyle(highlight ? "\033[1;30;46m" : sgr);
+        };
+
+        style("\033[1;34m");
+        screen.print("│ ");
+
+        snprintf(buf, sizeof(buf), "%d", proc.pid);
+        screen.printPadded(buf, 7, true);
+
+        screen.print(" │ ");
+
+        // Имя процесса (обрезаем если длинное); у процесса с потоками - значок
+        // свернут/развернут, в дереве перед ним отступ с ветками
+        bool has_threads = rows[i].has_threads;
+        const std::string& branch = rows[i].branch;
+        size_t branch_width = rows[i].branch_width;
+        size_t name_width = 18 - branch_width - (has_threads ? 2 : 0);
+        std::string name = proc.name;
+        if (name.length() > name_width) {
+            name = name.substr(0, name_width - 3) + "...";
+        }
+        if (has_threads) {
+            name = (isCollapsed(proc.pid) ? "▸ " : "▾ ") + name;
+        }
+        if (!branch.empty()) {
+            style("\033[1;34m");
+            screen.print(branch);
+        }
+
+        style("\033[1;37m");
+        screen.printPadded(name, static_cast<int>(18 - branch_width));
+
+        style("\033[1;34m");
+        screen.print(" │ ");
+
+        // Состояние с цветом
+        if (config.show_process_state) {
+            if (proc.state == "Z") style("\033[1;31m");      // Красный для зомби
+            else if (proc.state == "D") style("\033[1;33m"); // Желтый для ожидания
+            else style("\033[1;32m");                        // Зеленый по умолчанию
+
+            screen.printPadded(proc.state, 7);
+        }
+
+        style("\033[1;34m");
+        screen.print(" │ ");
+
+        // Пользователь
+        if (config.show_process_user) {
+            std::string user = proc.user;
+            if (user.length() > 12) {
+                user = user.substr(0, 9) + "...";
+            }
+            style("\033[1;36m");
+            screen.printPadded(user, 12);
+        } else {
+            screen.printPadded("", 12);
+        }
+
+        style("\033[1;34m");
+        screen.print(" │ ");
+
+        // CPU% процесса с порогами, как у строк потоков
+        style(proc.cpu_percent >= 50.0 ? "\033[1;31m" : proc.cpu_percent >= 5.0 ? "\033[1;33m" : "\033[1;90m");
+        snprintf(buf, sizeof(buf), "%.1f", proc.cpu_percent);
+        screen.printPadded(buf, 6, true);
+
+        style("\033[1;34m");
+        screen.print(" │ ");
+
+        // Память; пока smaps_rollup не прочитан (или недоступен) - RSS серым.
+        // В дереве - итог поддерева, в котором PSS уже учтен, где известен
+        if (tree) {
+            style("\033[1;35m");
+            screen.printPadded(formatBytes(proc.tree_memory_kb * 1024), 12, true);
+        } else if (pss && proc.smaps) {
+            style("\033[1;35m");
+            screen.printPadded(formatBytes(proc.pss_kb * 1024), 12, true);
+        } else {
+            style(pss ? "\033[1;90m" : "\033[1;35m");
+            screen.printPadded(formatBytes(proc.memory_kb * 1024), 12, true);
+        }
+
+        // Чтение/запись диска в секунду; "-" до второго замера или без доступа к io
+        if (tree) {
+            style("\033[1;34m");
+            screen.print(" │ ");
+            style(proc.tree_cpu_percent >= 1.0 ? "\033[1;33m" : "\033[1;90m");
+            snprintf(buf, sizeof(buf), "%.1f%%", proc.tree_cpu_percent);
+            screen.printPadded(buf, 12, true);
+        } else if (io) {
+            style("\033[1;34m");
+            screen.print(" │ ");
+            if (proc.io) {
+                bool busy = proc.io_read_rate + proc.io_write_rate > 0.0;
+                style(busy ? "\033[1;33m" : "\033[1;90m");
+                std::string rates = formatIoRate(proc.io_read_rate) + "/" + formatIoRate(proc.io_write_rate);
+                screen.printPadded(rates, 12, true);
+            } else {
+                style("\033[1;90m");
+                screen.printPadded("-", 12, true);
+            }
+        }
+
+        style("\033[1;34m");
+        screen.print(" │\n");
+    }
+
+    screen.setStyle("\033[1;34m");
+    screen.print("╰─────────┴────────────────────┴─────────┴──────────────┴────────┴──────────────");
+    screen.print(io ? "┴──────────────╯\n" : "╯\n");
+    screen.resetStyle();
+}
+
+size_t Display::formatBranch(const ProcessInfo& proc, std::string& branch) {
+    // Строки идут в прямом порядке: для каждого уровня помним, будут ли
+    // еще братья, и рисуем под ним вертикальную линию
+    size_t depth = static_cast<size_t>(proc.depth);
+    if (open_branches.size() <= depth) open_branches.resize(depth + 1);
+    open_branches[depth] = !proc.last_child;
+    if (depth == 0) return 0;
+
+    // Глубже max_levels уровней рисуются только нижние, чтобы осталось место имени
+    const size_t max_levels = 6;
+    size_t first = depth > max_levels ? depth - max_levels + 1 : 1;
+    for (size_t level = first; level < depth; ++level) {
+        branch += open_branches[level] ? "│ " : "  ";
+    }
+    branch += proc.last_child ? "└ " : "├ ";
+    return (depth - first + 1) * 2;
+}
+
+void Display::printThreadRow(const ProcessInfo& thread, bool io) {
+    char buf[32];
+
+    screen.setStyle("\033[1;34m");
+    screen.print("│ ");
+    screen.setStyle("\033[90m");
+    snprintf(buf, sizeof(buf), "%d", thread.pid);
+    screen.printPadded(buf, 7, true);
+
+    screen.setStyle("\033[1;34m");
+    screen.print(" │ ");
+    std::string name = thread.name;
+    if (name.length() > 16) {
+        name = name.substr(0, 13) + "...";
+    }
+    screen.setStyle("\033[37m");
+    screen.printPadded("└ " + name, 18);
+
+    screen.setStyle("\033[1;34m");
+    screen.print(" │ ");
+    if (config.show_process_state) {
+        if (thread.state == "Z") screen.setStyle("\033[31m");
+        else if (thread.state == "D") screen.setStyle("\033[33m");
+        else screen.setStyle("\033[32m");
+        screen.printPadded(thread.state, 7);
+    } else {
+        screen.printPadded("", 7);
+    }
+
+    // Пользователь и память у потоков общие с процессом - только CPU% потока
+    screen.setStyle("\033[1;34m");
+    screen.print(" │ ");
+    screen.printPadded("", 12);
+    screen.print(" │ ");
+    screen.setStyle(thread.cpu_percent >= 50.0 ? "\033[1;31m" : thread.cpu_percent >= 5.0 ? "\033[1;33m" : "\033[90m");
+    snprintf(buf, sizeof(buf), "%.1f", thread.cpu_percent);
+    screen.printPadded(buf, 6, true);
+
+    screen.setStyle("\033[1;34m");
+    screen.print(" │ ");
+    screen.printPadded("", 12);
+
+    if (io) {
+        screen.setStyle("\033[1;34m");
+        screen.print(" │ ");
+        screen.printPadded("", 12);
+    }
+
+    screen.setStyle("\033[1;34m");
+    screen.print(" │\n");
+}
+
+void Display::printCgroups(const SystemStats& stats) {
+    char buf[32];
+
+    screen.setStyle("\033[1;34m");
+    screen.print("╭──────────────────────────────────────┬───────┬────────┬────────────┬─────────╮\n");
+    screen.print("│                CGROUP                │ PROCS │  CPU%  │   MEMORY   │ MEM PSI │\n");
+    screen.print("├──────────────────────────────────────┼───────┼────────┼────────────┼─────────┤\n");
+
+    // Группы не выбираются и не прокручиваются - показываем первые, что помещаются
+    int available = screen.rows() - screen.cursorRow() - 3;
+    page_rows = std::max(0, available);
+    size_t visible = std::min(stats.cgroups.size(), static_cast<size_t>(page_rows));
+
+    for (size_t i = 0; i < visible; ++i) {
+        const CgroupInfo& group = stats.cgroups[i];
+
+        screen.print("│ ");
+
+        // Длинный путь обрезаем слева: значимая часть - последние компоненты
+        std::string path = group.path;
+        if (path.length() > 36) {
+            path = "..." + path.substr(path.length() - 33);
+        }
+        screen.setStyle("\033[1;37m");
+        screen.printPadded(path, 36);
+
+        screen.setStyle("\033[1;34m");
+        screen.print(" │ ");
+        screen.setStyle("\033[1;36m");
+        snprintf(buf, sizeof(buf), "%d", group.process_count);
+        screen.printPadded(buf, 5, true);
+
+        screen.setStyle("\033[1;34m");
+        screen.print(" │ ");
+        screen.setStyle("\033[1;32m");
+        snprintf(buf, sizeof(buf), "%.1f", group.cpu_percent);
+        screen.printPadded(buf, 6, true);
+
+        screen.setStyle("\033[1;34m");
+        screen.print(" │ ");
+        screen.setStyle("\033[1;35m");
+        screen.printPadded(formatBytes(group.memory_kb * 1024), 10, true);
+
+        // Давление памяти группы за 10 секунд (some avg10)
+        screen.setStyle("\033[1;34m");
+        screen.print(" │ ");
+        if (group.has_pressure) {
+            double level = group.memory_pressure.some[0];
+            screen.setStyle(level < 10.0 ? "\033[32m" : level < 40.0 ? "\033[33m" : "\033[31m");
+            snprintf(buf, sizeof(buf), "%.1f", level);
+            screen.printPadded(buf, 7, true);
+        } else {
+            screen.printPadded("-", 7, true);
+        }
+
+        screen.setStyle("\033[1;34m");
+        screen.print(" │\n");
+    }
+
+    screen.setStyle("\033[1;34m");
+    screen.print("╰──────────────────────────────────────┴───────┴────────┴────────────┴─────────╯\n");
+    screen.resetStyle();
+}
+
+void Display::printFooter() {
+    static const char* sort_names[] = {"memory", "cpu", "pid", "name", "io"};
+
+    char buf[192];
+    snprintf(buf, sizeof(buf), "q quit  c/m/p/n/i sort  r reverse  g group  T tree  t threads  / filter  space pause  k kill | by %s%s%s%s%s | %gs",
+             sort_names[static_cast<int>(config.sort_by)], config.reverse_sort ? " (reversed)" : "",
+             config.group_by == MtopConfig::GroupBy::CGROUP ? " | cgroups" : "",
+             config.name_filter.empty() ? "" : " | filter: ", config.name_filter.c_str(),
+             config.update_interval);
+
+    screen.newline();
+    screen.setStyle("\033[1;90m");
+    screen.print(status_line.empty() ? std::string_view(buf) : std::string_view(status_line));
+    screen.resetStyle();
+}
+
+// Цвета сегментов общие для разбивки и составной полосы CPU
+namespace {
+
+const char* const user_style = "\033[32m";
+const char* const nice_style = "\033[34m";
+const char* const system_style = "\033[31m";
+const char* const iowait_style = "\033[90m";
+const char* const irq_style = "\033[35m";
+const char* const steal_style = "\033[36m";
+const char* const guest_style = "\033[33m";
+
+} // namespace
+
+void Display::printCpuBreakdown(const SystemStats& stats) {
+    const CpuBreakdown& cpu = stats.cpu_breakdown;
+    const struct {
+        const char* label;
+        double value;
+        const char* style;
+    } parts[] = {
+        {"us", cpu.user, user_style},
+        {"sy", cpu.system, system_style},
+        {"ni", cpu.nice, nice_style},
+        {"wa", cpu.iowait, iowait_style},
+        {"hi", cpu.irq, irq_style},
+        {"si", cpu.softirq, irq_style},
+        {"st", cpu.steal, steal_style},
+        {"gu", cpu.guest, guest_style},
+    };
+
+    char buf[64];
+    for (const auto& part : parts) {
+        screen.setStyle("\033[1;90m");
+        screen.print(" ");
+        screen.print(part.label);
+        screen.print(" ");
+        screen.setStyle(part.style);
+        snprintf(buf, sizeof(buf), "%.1f", part.value);
+        screen.print(buf);
+    }
+
+    // Готовые к запуску и ждущие ввода-вывода - из того же чтения /proc/stat
+    screen.setStyle("\033[1;90m");
+    snprintf(buf, sizeof(buf), "  run %d  blk %d", stats.procs_running, stats.procs_blocked);
+    screen.print(buf);
+    screen.resetStyle();
+    screen.newline();
+}
+
+void Display::printMemoryDetail(const MemInfo& mem) {
+    const struct {
+        const char* label;
+        uint64_t kb;
+    } parts[] = {
+        {"buf", mem.buffers_kb},
+        {"cache", mem.cached_kb},
+        {"shm", mem.shmem_kb},
+        {"slab", mem.slab_kb},
+        {"dirty", mem.dirty_kb},
+        {"wb", mem.writeback_kb},
+    };
+
+    screen.print("    ");
+    for (const auto& part : parts) {
+        screen.setStyle("\033[1;90m");
+        screen.print(" ");
+        screen.print(part.label);
+        screen.print(" ");
+        screen.setStyle("\033[36m");
+        screen.print(formatBytes(part.kb * 1024));
+    }
+
+    // Своп и huge pages - занято/всего; huge pages только если они выделены
+    screen.setStyle("\033[1;90m");
+    screen.print(" swap ");
+    screen.setStyle(mem.swap_total_kb > mem.swap_free_kb ? "\033[33m" : "\033[36m");
+    screen.print(formatBytes((mem.swap_total_kb - std::min(mem.swap_free_kb, mem.swap_total_kb)) * 1024));
+    screen.print("/");
+    screen.print(formatBytes(mem.swap_total_kb * 1024));
+    if (mem.hugepages_total > 0) {
+        uint64_t used = mem.hugepages_total - std::min(mem.hugepages_free, mem.hugepages_total);
+        screen.setStyle("\033[1;90m");
+        screen.print(" huge ");
+        screen.setStyle("\033[36m");
+        screen.print(formatBytes(used * mem.hugepage_size_kb * 1024));
+        screen.print("/");
+        screen.print(formatBytes(mem.hugepages_total * mem.hugepage_size_kb * 1024));
+    }
+    screen.resetStyle();
+    screen.newline();
+}
+
+void Display::printPressure(const SystemStats& stats) {
+    const struct {
+        const char* label;
+        const PressureInfo& info;
+        bool show_full; // full для CPU на уровне системы всегда 0
+    } resources[] = {
+        {"cpu", stats.cpu_pressure, false},
+        {"mem", stats.memory_pressure, true},
+        {"io", stats.io_pressure, true},
+    };
+
+    // Доля времени, когда задачи простаивали в ожидании ресурса: avg10 avg60 avg300
+    char buf[64];
+    screen.setStyle("\033[1m\033[93m");
+    screen.print("PSI: ");
+    for (const auto& resource : resources) {
+        const PressureInfo& info = resource.info;
+        screen.setStyle("\033[1;90m");
+        screen.print(resource.label);
+        screen.print(" ");
+
+        // Зеленый - до 10%, желтый - до 40%, красный - выше (по avg10)
+        double level = info.some[0];
+        screen.setStyle(level < 10.0 ? "\033[32m" : level < 40.0 ? "\033[33m" : "\033[31m");
+        snprintf(buf, sizeof(buf), "%.1f %.1f %.1f", info.some[0], info.some[1], info.some[2]);
+        screen.print(buf);
+        if (resource.show_full) {
+            snprintf(buf, sizeof(buf), " full %.1f", info.full[0]);
+            screen.print(buf);
+        }
+        screen.print("  ");
+    }
+    screen.resetStyle();
+    screen.newline();
+}
+
+void Display::printCoreStrip(const std::vector<float>& core_percent) {
+    static const char* levels[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    static const char label[] = "Cores ";
+    const int max_lines = 2;
+
+    // Одна клетка на ядро; если ядер больше, чем клеток в двух строках,
+    // клетка показывает максимум группы - загруженное ядро не теряется
+    int width = std::max(1, screen.cols() - static_cast<int>(sizeof(label) - 1));
+    size_t cells = static_cast<size_t>(width) * max_lines;
+    size_t group = (core_percent.size() + cells - 1) / cells;
+    size_t count = (core_percent.size() + group - 1) / group;
+
+    const char* current = nullptr;
+    for (size_t cell = 0; cell < count; ++cell) {
+        if (cell % static_cast<size_t>(width) == 0) {
+            if (cell > 0) screen.newline();
+            screen.setStyle("\033[1;33m");
+            screen.print(cell == 0 ? label : "      ");
+            current = nullptr;
+        }
+
+        size_t begin = cell * group;
+        size_t end = std::min(begin + group, core_percent.size());
+        float percent = *std::max_element(core_percent.begin() + begin, core_percent.begin() + end);
+
+        // Зеленый - до 50%, желтый - до 80%, красный - выше
+        const char* style = percent < 50.0f ? "\033[32m" : percent < 80.0f ? "\033[33m" : "\033[31m";
+        if (style != current) {
+            screen.setStyle(style);
+            current = style;
+        }
+        int level = std::min(7, std::max(0, static_cast<int>(percent / 12.5f)));
+        screen.print(levels[level]);
+    }
+    screen.resetStyle();
+    screen.newline();
+}
+
+void Display::printProgressBar(double value, double max_value, int width) {
+    double percent = value / max_value;
+    int filled = static_cast<int>(percent * width);
+
+    screen.setStyle("\033[1;32m"); // Зеленый для прогресс-бара
+    screen.print("[");
+    for (int i = 0; i < width; ++i) {
+        screen.print(i < filled ? "█" : " ");
+    }
+    screen.print("]");
+    screen.resetStyle();
+}
+
+void Display::printStackedCpuBar(const CpuBreakdown& cpu, int width) {
+    const struct {
+        double value;
+        const char* style;
+    } segments[] = {
+        {cpu.user, user_style},
+        {cpu.nice, nice_style},
+        {cpu.system, system_style},
+        {cpu.irq + cpu.softirq, irq_style},
+        {cpu.iowait, iowait_style},
+        {cpu.steal, steal_style},
+        {cpu.guest, guest_style},
+    };
+
+    // Границы сегментов от накопленной суммы - ошибки округления не копятся
+    screen.setStyle("\033[1;32m");
+    screen.print("[");
+    double sum = 0.0;
+    int cell = 0;
+    for (const auto& segment : segments) {
+        sum += segment.value;
+        int boundary = std::min(width, static_cast<int>(sum * width / 100.0 + 0.5));
+        screen.setStyle(segment.style);
+        for (; cell < boundary; ++cell) {
+            screen.print("█");
+        }
+    }
+    for (; cell < width; ++cell) {
+        screen.print(" ");
+    }
+    screen.setStyle("\033[1;32m");
+    screen.print("]");
+    screen.resetStyle();
+}
+
+std::string Display::formatRate(double per_second) {
+    char buf[32];
+    if (per_second >= 1e6) {
+        snprintf(buf, sizeof(buf), "%.1fM", per_second / 1e6);
+    } else if (per_second >= 1e4) {
+        snprintf(buf, sizeof(buf), "%.1fk", per_second / 1e3);
+    } else {
+        snprintf(buf, sizeof(buf), "%.0f", per_second);
+    }
+    return buf;
+}
+
+std::string Display::formatIoRate(double bytes_per_second) {
+    // Не шире 5 символов, чтобы "чтение/запись" помещались в колонку
+    const char* units[] = {"", "K", "M", "G", "T"};
+    int unit_index = 0;
+    while (bytes_per_second >= 1000.0 && unit_index < 4) {
+        bytes_per_second /= 1024.0;
+        unit_index++;
+    }
+
+    char buf[16];
+    if (unit_index > 0 && bytes_per_second < 10.0) {
+        snprintf(buf, sizeof(buf), "%.1f%s", bytes_per_second, units[unit_index]);
+    } else {
+        snprintf(buf, sizeof(buf), "%.0f%s", bytes_per_second, units[unit_index]);
+    }
+    return buf;
+}
+
+std::string Display::formatBytes(uint64_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit_index = 0;
+    double size = static_cast<double>(bytes);
+
+    while (size >= 1024.0 && unit_index < 4) {
+        size /= 1024.0;
+        unit_index++;
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f%s", size, units[unit_index]);
+    return buf;
+}
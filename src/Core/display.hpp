@@ -0,0 +1,68 @@
+#ifndef DISPLAY_HPP
+#define DISPLAY_HPP
+
+#include <string>
+#include "parser.hpp"
+#include "screen.hpp"
+#include "system_info.hpp"
+
+class Display {
+public:
+    Display(const MtopConfig& config);
+    ~Display() = default;
+
+    void updateConfig(const MtopConfig& new_config);
+
+    // Composes a full frame and writes only what changed since the last one
+    void render(const SystemStats& stats);
+
+    // Replaces the footer hint line; empty restores the default
+    void setStatusLine(const std::string& text);
+
+    // Highlights the row with this PID (-1 = none) and scrolls it into view
+    void setSelectedPid(int pid);
+
+    // Hides (or shows again) the thread rows under this PID
+    void setThreadsCollapsed(int pid, bool collapsed);
+
+    // Process rows that fit on screen in the last frame, for paging
+    int pageRows() const { return page_rows; }
+
+private:
+    MtopConfig config;
+    Screen screen;
+    std::string status_line;
+    int selected_pid;
+    size_t first_row; // scroll offset of the process table
+    int page_rows;
+    struct TableRow {
+        const ProcessInfo* info; // tgid != 0 for thread rows
+        bool has_threads;        // a process row with thread rows (shown or collapsed)
+        std::string branch;      // tree view: indentation and branch glyphs
+        size_t branch_width;     // glyphs of branch
+    };
+    std::vector<TableRow> rows; // rows of the process table in the last frame
+    std::vector<int> collapsed_pids;      // processes whose threads are hidden
+    std::vector<bool> open_branches;      // tree view: levels with siblings still to come
+
+    void printHeader();
+    void printSystemStats(const SystemStats& stats);
+    void printCpuBreakdown(const SystemStats& stats);
+    void printCoreStrip(const std::vector<float>& core_percent);
+    void printMemoryDetail(const MemInfo& mem);
+    void printPressure(const SystemStats& stats);
+    void printProcesses(const SystemStats& stats);
+    void printThreadRow(const ProcessInfo& thread, bool io);
+    size_t formatBranch(const ProcessInfo& proc, std::string& branch);
+    void printCgroups(const SystemStats& stats);
+    void printFooter();
+
+    void printProgressBar(double value, double max_value, int width);
+    void printStackedCpuBar(const CpuBreakdown& cpu, int width);
+    std::string formatBytes(uint64_t bytes);
+    std::string formatRate(double per_second);
+    std::string formatIoRate(double bytes_per_second);
+    bool isCollapsed(int pid) const;
+};
+
+#endif // DISPLAY_HPP
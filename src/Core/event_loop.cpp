@@ -0,0 +1,152 @@
+#include "event_loop.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+
+timespec toTimespec(double seconds) {
+    timespec ts;
+    double whole = std::floor(seconds);
+    ts.tv_sec = static_cast<time_t>(whole);
+    ts.tv_nsec = static_cast<long>((seconds - whole) * 1e9);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+} // namespace
+
+EventLoop::EventLoop() : timer_fd(-1), signal_fd(-1) {
+}
+
+EventLoop::~EventLoop() {
+    if (timer_fd >= 0) close(timer_fd);
+    if (signal_fd >= 0) close(signal_fd);
+}
+
+bool EventLoop::open(std::string& error) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGWINCH);
+
+    // Сигналы блокируются до создания потоков - потоки наследуют маску,
+    // и сигнал доходит только через signalfd
+    int err = pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    if (err != 0) {
+        error = strerror(err);
+        return false;
+    }
+
+    signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        error = std::string("signalfd: ") + strerror(errno);
+        return false;
+    }
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        error = std::string("timerfd_create: ") + strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+void EventLoop::setInterval(double interval, double first_delay) {
+    arm(std::max(0.0, first_delay), std::max(min_interval, interval));
+}
+
+void EventLoop::setTimeout(double delay) {
+    arm(std::max(0.0, delay), 0.0);
+}
+
+void EventLoop::stopTimer() {
+    itimerspec spec = {};
+    timerfd_settime(timer_fd, 0, &spec, nullptr);
+
+    uint64_t expirations;
+    while (read(timer_fd, &expirations, sizeof(expirations)) > 0) {
+    }
+}
+
+void EventLoop::arm(double first_delay, double interval) {
+    // Абсолютный дедлайн по монотонным часам: период отсчитывается от
+    // предыдущего срабатывания, а не от момента, когда мы успели прочитать таймер
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double deadline = static_cast<double>(now.tv_sec) + now.tv_nsec / 1e9 + first_delay;
+
+    itimerspec spec;
+    spec.it_value = toTimespec(deadline);
+    spec.it_interval = toTimespec(interval);
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    // Срабатывания старого расписания больше не актуальны
+    uint64_t expirations;
+    while (read(timer_fd, &expirations, sizeof(expirations)) > 0) {
+    }
+}
+
+void EventLoop::watch(int fd) {
+    if (std::find(watched.begin(), watched.end(), fd) == watched.end()) {
+        watched.push_back(fd);
+    }
+}
+
+void EventLoop::unwatch(int fd) {
+    watched.erase(std::remove(watched.begin(), watched.end(), fd), watched.end());
+}
+
+EventLoop::Event EventLoop::wait(int& ready_fd) {
+    std::vector<pollfd> fds(2 + watched.size());
+    fds[0] = {signal_fd, POLLIN, 0};
+    fds[1] = {timer_fd, POLLIN, 0};
+    for (size_t i = 0; i < watched.size(); ++i) {
+        fds[2 + i] = {watched[i], POLLIN, 0};
+    }
+
+    while (true) {
+        int n = poll(fds.data(), fds.size(), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return Event::Error;
+        }
+
+        // Сигналы важнее таймера: Ctrl+C не ждет очередного сбора
+        if (fds[0].revents & POLLIN) {
+            signalfd_siginfo info;
+            if (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+                return info.ssi_signo == SIGWINCH ? Event::Resize : Event::Quit;
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            // Число пропущенных срабатываний не важно - догонять их не нужно
+            uint64_t expirations;
+            if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                return Event::Tick;
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ready_fd = fds[i].fd;
+                return Event::Input;
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <string>
+#include <vector>
+
+// poll()-based main loop over a CLOCK_MONOTONIC timerfd and a signalfd.
+// The periodic timer is armed on an absolute deadline, so ticks do not
+// drift by the time spent collecting; ticks missed while busy collapse
+// into one. SIGINT/SIGTERM/SIGWINCH are delivered through the signalfd,
+// which wakes wait() immediately instead of after the current sleep.
+class EventLoop {
+public:
+    enum class Event {
+        Tick,    // timer expired
+        Quit,    // SIGINT or SIGTERM
+        Resize,  // SIGWINCH
+        Input,   // a watched descriptor is readable
+        Error
+    };
+
+    static constexpr double min_interval = 0.01;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Blocks the handled signals for the calling thread and creates the
+    // descriptors. Call before starting any threads: they inherit the mask,
+    // otherwise a signal may be delivered to a thread that never reads it.
+    bool open(std::string& error);
+
+    // Periodic ticks every interval seconds, the first after first_delay
+    void setInterval(double interval, double first_delay);
+
+    // Single tick after delay seconds; replaces any periodic schedule
+    void setTimeout(double delay);
+
+    // Disarms the timer; no Tick until it is set again
+    void stopTimer();
+
+    // Reports Input with the descriptor when fd becomes readable
+    void watch(int fd);
+    void unwatch(int fd);
+
+    // Blocks until the next event; ready_fd is set for Input
+    Event wait(int& ready_fd);
+
+private:
+    int timer_fd;
+    int signal_fd;
+    std::vector<int> watched;
+
+    void arm(double first_delay, double interval);
+};
+
+#endif // EVENT_LOOP_HPP
@@ -0,0 +1,105 @@
+#include "keyboard.hpp"
+#include <cerrno>
+#include <unistd.h>
+
+Keyboard::Keyboard() : input_fd(STDIN_FILENO), active(false) {
+    if (!isatty(input_fd) || tcgetattr(input_fd, &saved) != 0) {
+        return;
+    }
+
+    struct termios raw = saved;
+    // Посимвольный ввод без эха; ISIG оставляем - Ctrl+C приходит через signalfd.
+    // VMIN = VTIME = 0 делает read() неблокирующим на уровне терминала:
+    // O_NONBLOCK на stdin задел бы и stdout, если это одно открытие tty
+    raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(input_fd, TCSAFLUSH, &raw) != 0) {
+        return;
+    }
+    active = true;
+}
+
+Keyboard::~Keyboard() {
+    if (active) {
+        tcsetattr(input_fd, TCSAFLUSH, &saved);
+    }
+}
+
+bool Keyboard::read(std::vector<int>& keys) {
+    char buf[256];
+    while (true) {
+        // 0 - данных больше нет (VMIN = 0); обрыв терминала завершит нас через SIGHUP
+        ssize_t n = ::read(input_fd, buf, sizeof(buf));
+        if (n > 0) {
+            pending.append(buf, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+
+        decode(keys);
+        return n == 0 || errno == EAGAIN;
+    }
+}
+
+void Keyboard::decode(std::vector<int>& keys) {
+    size_t i = 0;
+    while (i < pending.size()) {
+        unsigned char c = static_cast<unsigned char>(pending[i]);
+
+        if (c == '\r' || c == '\n') {
+            keys.push_back(Enter);
+            i++;
+            continue;
+        }
+        if (c == 0x7F || c == 0x08) {
+            keys.push_back(Backspace);
+            i++;
+            continue;
+        }
+        if (c != 0x1B) {
+            keys.push_back(c);
+            i++;
+            continue;
+        }
+
+        // ESC в конце прочитанного - отдельное нажатие Esc, а не начало последовательности
+        if (i + 1 >= pending.size() || (pending[i + 1] != '[' && pending[i + 1] != 'O')) {
+            keys.push_back(Escape);
+            i++;
+            continue;
+        }
+
+        // CSI/SS3: параметры до финального байта 0x40..0x7E
+        size_t end = i + 2;
+        while (end < pending.size() &&
+               !(pending[end] >= 0x40 && pending[end] <= 0x7E)) {
+            end++;
+        }
+        if (end >= pending.size()) {
+            break; // последовательность еще не дочитана
+        }
+
+        std::string params = pending.substr(i + 2, end - i - 2);
+        switch (pending[end]) {
+            case 'A': keys.push_back(Up); break;
+            case 'B': keys.push_back(Down); break;
+            case 'C': keys.push_back(Right); break;
+            case 'D': keys.push_back(Left); break;
+            case 'H': keys.push_back(Home); break;
+            case 'F': keys.push_back(End); break;
+            case '~':
+                if (params == "5") keys.push_back(PageUp);
+                else if (params == "6") keys.push_back(PageDown);
+                else if (params == "1" || params == "7") keys.push_back(Home);
+                else if (params == "4" || params == "8") keys.push_back(End);
+                break;
+            default:
+                break; // неизвестные последовательности пропускаем целиком
+        }
+        i = end + 1;
+    }
+
+    pending.erase(0, i);
+}
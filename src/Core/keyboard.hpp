@@ -0,0 +1,53 @@
+#ifndef KEYBOARD_HPP
+#define KEYBOARD_HPP
+
+#include <string>
+#include <vector>
+#include <termios.h>
+
+// Puts the controlling terminal into non-canonical, no-echo mode with
+// non-blocking reads (VMIN = VTIME = 0) and decodes its input into keys.
+// ISIG is left on, so Ctrl+C still arrives as SIGINT. The previous
+// terminal settings are restored on destruction.
+class Keyboard {
+public:
+    // Plain bytes are returned as themselves (0..255); special keys use
+    // values above that range
+    enum Key : int {
+        Up = 0x100,
+        Down,
+        Left,
+        Right,
+        PageUp,
+        PageDown,
+        Home,
+        End,
+        Enter,
+        Backspace,
+        Escape
+    };
+
+    Keyboard();
+    ~Keyboard();
+
+    Keyboard(const Keyboard&) = delete;
+    Keyboard& operator=(const Keyboard&) = delete;
+
+    // False when stdin is not a terminal; no keys will be delivered
+    bool isActive() const { return active; }
+    int fd() const { return input_fd; }
+
+    // Appends every complete key that can be read without blocking.
+    // Returns false when reading stdin failed.
+    bool read(std::vector<int>& keys);
+
+private:
+    int input_fd;
+    bool active;
+    struct termios saved;
+    std::string pending;
+
+    void decode(std::vector<int>& keys);
+};
+
+#endif // KEYBOARD_HPP
@@ -1,183 +1,448 @@
 #include <ios>
 #include <iostream>
 #include <iomanip>
-#include <thread>
 #include <chrono>
-#include <csignal>
 #include <termios.h>
 #include <unistd.h>
 #include "system_info.hpp"
+#include "display.hpp"
+#include "event_loop.hpp"
+#include "keyboard.hpp"
+#include "sampler.hpp"
+#include "serializer.hpp"
+#include "recording.hpp"
 #include "parser.hpp"
-#include <cstdlib>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <vector>
+#include <fcntl.h>
+
+double currentTimestamp() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Состояние интерактивного режима между нажатиями клавиш
+struct InteractiveState {
+    enum class Mode {
+        Normal,
+        Filter,  // ввод фильтра по имени
+        Confirm  // подтверждение отправки сигнала
+    };
+    
+    MtopConfig config;
+    std::shared_ptr<const SystemStats> stats;
+    Mode mode = Mode::Normal;
+    bool paused = false;
+    bool show_next = false;  // снимок после смены сортировки показываем и на паузе
+    int selected_pid = -1;
+    size_t selected_index = 0;
+    int kill_pid = -1;
+    int kill_signal = SIGTERM;
+    std::string kill_name;
+    std::string message;
+};
 
-class Display {
-public:
-    Display(const MtopConfig& config) : config(config) {
-        // Скрываем курсор
-        std::cout << "\033[?25l";
+// Сортировка и фильтры уходят в Sampler: он пересобирает вид по последнему скану без чтения /proc
+void applyConfig(InteractiveState& state, Display& display, Sampler& sampler) {
+    display.updateConfig(state.config);
+    sampler.updateConfig(state.config);
+    state.show_next = true;
+}
+
+// Выбор следует за PID между снимками; если процесс исчез - остаемся на той же позиции
+void syncSelection(InteractiveState& state) {
+    if (state.selected_pid < 0 || !state.stats) return;
+    
+    const auto& processes = state.stats->processes;
+    for (size_t i = 0; i < processes.size(); ++i) {
+        if (processes[i].pid == state.selected_pid) {
+            state.selected_index = i;
+            return;
+        }
     }
     
-    ~Display() {
-        // Показываем курсор
-        std::cout << "\033[?25h";
-        std::cout << "\033[0m"; // Сброс цветов
+    if (processes.empty()) {
+        state.selected_pid = -1;
+        return;
     }
+    state.selected_index = std::min(state.selected_index, processes.size() - 1);
+    state.selected_pid = processes[state.selected_index].pid;
+}
+
+void moveSelection(InteractiveState& state, long delta) {
+    // В режиме групп строки таблицы - cgroup, процессы не выбираются
+    if (!state.stats || state.stats->processes.empty() || state.stats->cgroup_view) return;
+    
+    const auto& processes = state.stats->processes;
+    long index = state.selected_pid < 0 ? (delta > 0 ? -1 : 0) : static_cast<long>(state.selected_index);
+    index = std::clamp(index + delta, 0L, static_cast<long>(processes.size()) - 1);
     
-    void updateConfig(const MtopConfig& new_config) {
-        config = new_config;
+    state.selected_index = static_cast<size_t>(index);
+    state.selected_pid = processes[state.selected_index].pid;
+}
+
+void requestKill(InteractiveState& state, int signal) {
+    if (state.stats && state.stats->cgroup_view) {
+        state.message = "Turn off the cgroup view (g) to select a process";
+        return;
+    }
+    if (state.selected_pid < 0 || !state.stats) {
+        state.message = "Select a process first (Up/Down)";
+        return;
     }
     
-    void printHeader() {
-        std::cout << "\033[1;36m"; // Яркий голубой
-        std::cout << "╭───────────────────────────────────╮\n";
-        std::cout << "│ \033[1;35mmtop 2\033[1;36m - Modern Top 2 by TheMomer │\n";
-        std::cout << "╰───────────────────────────────────╯\033[0m\n";
+    state.kill_pid = state.selected_pid;
+    state.kill_signal = signal;
+    state.kill_name = state.stats->processes[state.selected_index].name;
+    state.mode = InteractiveState::Mode::Confirm;
+}
+
+void sendKill(InteractiveState& state) {
+    const char* name = state.kill_signal == SIGKILL ? "SIGKILL" : "SIGTERM";
+    char buf[160];
+    if (kill(state.kill_pid, state.kill_signal) == 0) {
+        snprintf(buf, sizeof(buf), "Sent %s to %d (%s)", name, state.kill_pid, state.kill_name.c_str());
+    } else {
+        snprintf(buf, sizeof(buf), "Cannot send %s to %d: %s", name, state.kill_pid, strerror(errno));
     }
+    state.message = buf;
+}
+
+// Возвращает false, если нужно выйти
+bool handleKey(InteractiveState& state, int key, Display& display, Sampler& sampler) {
+    state.message.clear();
     
-    void printSystemStats(const SystemStats& stats) {
-        std::cout << "\033[1;33m"; // Желтый для заголовков
-        
-        // CPU
-        if (config.show_cpu_bar) {
-            std::cout << "\033[1m\033[93mCPU: ";
-            printProgressBar(stats.cpu_percent, 100.0, config.progress_bar_width);
-            std::cout << " " << std::fixed << std::setprecision(1) << stats.cpu_percent << "%\n";
-        } else {
-            std::cout << "CPU: " << std::fixed << std::setprecision(1) << stats.cpu_percent << "%\n";
-        }
-        
-        // Memory
-        double mem_percent = (static_cast<double>(stats.used_memory_kb) / stats.total_memory_kb) * 100.0;
-        if (config.show_memory_bar) {
-            std::cout << "\033[1m\033[93mMEM: ";
-            printProgressBar(mem_percent, 100.0, config.progress_bar_width);
-            std::cout << " " << std::fixed << std::setprecision(1) << mem_percent << "% ";
-            std::cout << "(" << formatBytes(stats.used_memory_kb * 1024) << "/" 
-                      << formatBytes(stats.total_memory_kb * 1024) << ")\n";
+    if (state.mode == InteractiveState::Mode::Filter) {
+        // Фильтр применяется на каждое нажатие - список сужается по мере ввода
+        std::string& filter = state.config.name_filter;
+        if (key == Keyboard::Enter) {
+            state.mode = InteractiveState::Mode::Normal;
+            return true;
+        } else if (key == Keyboard::Escape) {
+            filter.clear();
+            state.mode = InteractiveState::Mode::Normal;
+        } else if (key == Keyboard::Backspace) {
+            // Удаляем символ UTF-8 целиком вместе с байтами продолжения
+            while (!filter.empty() && (static_cast<unsigned char>(filter.back()) & 0xC0) == 0x80) {
+                filter.pop_back();
+            }
+            if (!filter.empty()) filter.pop_back();
+        } else if (key >= 0x20 && key < 0x100 && key != 0x7F) {
+            filter += static_cast<char>(key);
         } else {
-            std::cout << "MEM: " << std::fixed << std::setprecision(1) << mem_percent << "% ";
-            std::cout << "(" << formatBytes(stats.used_memory_kb * 1024) << "/" 
-                      << formatBytes(stats.total_memory_kb * 1024) << ")\n";
+            return true;
         }
-        
-        // Load Average
-        if (config.show_load_avg) {
-            std::cout << "\033[1m\033[93mLoad: ";
-            std::cout << "\033[1;32m";
-            std::cout << std::fixed << std::setprecision(2) 
-                      << stats.load_avg[0] << " " << stats.load_avg[1] << " " << stats.load_avg[2];
-            std::cout << "\033[0m";
+        applyConfig(state, display, sampler);
+        return true;
+    }
+    
+    if (state.mode == InteractiveState::Mode::Confirm) {
+        if (key == 'y' || key == 'Y') {
+            sendKill(state);
         }
-        
-        std::cout << "  Processes: ";
-        std::cout << "\033[1;32m";
-        std::cout << stats.process_count;
-        std::cout << "\033[0m";
-        std::cout << "\n\n";
-    }
-    
-    void printProcesses(const SystemStats& stats) {
-        std::cout << "\033[1;34m"; // Синий для заголовка таблицы
-        std::cout << "╭─────────┬────────────────────┬─────────┬──────────────┬──────────────╮\n";
-        std::cout << "│   PID   │        NAME        │  STATE  │     USER     │    MEMORY    │\n";
-        std::cout << "├─────────┼────────────────────┼─────────┼──────────────┼──────────────┤\033[0m\n";
-        
-        for (const auto& proc : stats.processes) {
-            std::cout << "\033[1;34m│ ";
-            
-            std::cout << std::setw(7) <<  std::right << proc.pid;
-            
-            std::cout << "\033[1;34m │ ";
-            
-            // Имя процесса (обрезаем если длинное)
-            std::string name = proc.name;
-            if (name.length() > 18) {
-                name = name.substr(0, 15) + "...";
+        state.mode = InteractiveState::Mode::Normal;
+        return true;
+    }
+    
+    MtopConfig::SortBy sort_by = state.config.sort_by;
+    switch (key) {
+        case 'q':
+        case 'Q':
+            return false;
+        case 'c': sort_by = MtopConfig::SortBy::CPU; break;
+        case 'm': sort_by = MtopConfig::SortBy::MEMORY; break;
+        case 'p': sort_by = MtopConfig::SortBy::PID; break;
+        case 'n': sort_by = MtopConfig::SortBy::NAME; break;
+        case 'i': sort_by = MtopConfig::SortBy::IO; break;
+        case 'r':
+            state.config.reverse_sort = !state.config.reverse_sort;
+            applyConfig(state, display, sampler);
+            return true;
+        case 'g':
+            state.config.group_by = state.config.group_by == MtopConfig::GroupBy::CGROUP
+                                        ? MtopConfig::GroupBy::NONE : MtopConfig::GroupBy::CGROUP;
+            state.selected_pid = -1;
+            applyConfig(state, display, sampler);
+            return true;
+        case 'T':
+            state.config.tree_view = !state.config.tree_view;
+            applyConfig(state, display, sampler);
+            return true;
+        case 't':
+            state.config.show_threads = !state.config.show_threads;
+            applyConfig(state, display, sampler);
+            return true;
+        case Keyboard::Left:
+        case Keyboard::Right:
+            if (state.selected_pid >= 0) {
+                display.setThreadsCollapsed(state.selected_pid, key == Keyboard::Left);
             }
-            
-            std::cout << "\033[1;37m";
-            std::cout << std::setw(18) << std::left << name;
-            std::cout << "\033[0m";
-            
-            std::cout << "\033[1;34m │ ";
-            
-            // Состояние с цветом
-            if (config.show_process_state) {
-                std::string state_color = "\033[1;32m"; // Зеленый по умолчанию
-                if (proc.state == "Z") state_color = "\033[1;31m"; // Красный для зомби
-                else if (proc.state == "D") state_color = "\033[1;33m"; // Желтый для ожидания
+            return true;
+        case '/':
+            state.mode = InteractiveState::Mode::Filter;
+            return true;
+        case ' ':
+            state.paused = !state.paused;
+            return true;
+        case 'k': requestKill(state, SIGTERM); return true;
+        case 'K': requestKill(state, SIGKILL); return true;
+        case Keyboard::Up: moveSelection(state, -1); return true;
+        case Keyboard::Down: moveSelection(state, 1); return true;
+        case Keyboard::PageUp: moveSelection(state, -std::max(1, display.pageRows())); return true;
+        case Keyboard::PageDown: moveSelection(state, std::max(1, display.pageRows())); return true;
+        case Keyboard::Home: moveSelection(state, -static_cast<long>(INT_MAX)); return true;
+        case Keyboard::End: moveSelection(state, static_cast<long>(INT_MAX)); return true;
+        case Keyboard::Escape: state.selected_pid = -1; return true;
+        default: return true;
+    }
+    
+    if (sort_by != state.config.sort_by) {
+        state.config.sort_by = sort_by;
+        applyConfig(state, display, sampler);
+    }
+    return true;
+}
 
-                std::cout << state_color;
-                std::cout << std::setw(7) << std::left << proc.state;
-                std::cout << "\033[0m";
+std::string statusText(const InteractiveState& state) {
+    std::string text;
+    if (state.mode == InteractiveState::Mode::Filter) {
+        return "Filter: " + state.config.name_filter + "_   (Enter keep, Esc clear)";
+    }
+    if (state.mode == InteractiveState::Mode::Confirm) {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "Send %s to %d (%s)? [y/N]",
+                 state.kill_signal == SIGKILL ? "SIGKILL" : "SIGTERM", state.kill_pid, state.kill_name.c_str());
+        return buf;
+    }
+    if (state.paused) {
+        text = "PAUSED | ";
+        text += state.message.empty() ? "space resume  q quit" : state.message;
+        return text;
+    }
+    return state.message;
+}
+
+// Интерактивный режим: сбор идет в потоке Sampler, UI только рисует последний снимок
+// и обрабатывает клавиши. Display и Keyboard восстанавливают терминал при выходе
+void runInteractive(EventLoop& loop, SystemInfo& sysInfo, const MtopConfig& config, SessionRecorder* recorder) {
+    Display display(config);
+    Keyboard keyboard;
+    Sampler sampler(sysInfo, config, recorder);
+    
+    InteractiveState state;
+    state.config = config;
+    
+    loop.watch(sampler.notifyFd());
+    if (keyboard.isActive()) {
+        loop.watch(keyboard.fd());
+    }
+    
+    std::vector<int> keys;
+    int ready_fd;
+    bool running = true;
+    while (running) {
+        EventLoop::Event event = loop.wait(ready_fd);
+        
+        if (event == EventLoop::Event::Input && ready_fd == sampler.notifyFd()) {
+            auto latest = sampler.latest();
+            // На паузе держим старый снимок, кроме пересортировки по команде пользователя
+            if (state.paused && !state.show_next) continue;
+            state.stats = std::move(latest);
+            state.show_next = false;
+            syncSelection(state);
+            std::string recording_error;
+            if (sampler.takeRecordingError(recording_error)) {
+                state.message = "Recording stopped: " + recording_error;
+            }
+        } else if (event == EventLoop::Event::Input && ready_fd == keyboard.fd()) {
+            keys.clear();
+            if (!keyboard.read(keys)) {
+                loop.unwatch(keyboard.fd());
             }
-            
-            std::cout << "\033[1;34m │ ";
-            
-            // Пользователь
-            if (config.show_process_user) {
-                std::string user = proc.user;
-                if (user.length() > 12) {
-                    user = user.substr(0, 9) + "...";
+            for (int key : keys) {
+                if (!handleKey(state, key, display, sampler)) {
+                    running = false;
+                    break;
                 }
-                std::cout << "\033[1;36m";
-                std::cout << std::setw(12) << std::left << user;
-                std::cout << "\033[0m";
-            } else {
-                std::cout << std::setw(12) << " ";
             }
-            
-            std::cout << "\033[1;34m │ ";
-            
-            // Память
-            std::cout << "\033[1;35m";
-            std::cout << std::setw(12) << std::right << formatBytes(proc.memory_kb * 1024);
-            std::cout << "\033[0m\033[1;34m";
-            
-            std::cout << " │\n";
+            if (!running) break;
+        } else if (event != EventLoop::Event::Resize) {
+            break;
         }
         
-        std::cout << "\033[1;34m╰─────────┴────────────────────┴─────────┴──────────────┴──────────────╯\033[0m\n";
+        // Кадр собирается целиком и выводится одним write() - только изменения.
+        // Клавиши и SIGWINCH перерисовывают последний снимок сразу, не дожидаясь тика
+        if (state.stats) {
+            display.setSelectedPid(state.selected_pid);
+            display.setStatusLine(statusText(state));
+            display.render(*state.stats);
+        }
     }
     
-private:
-    MtopConfig config;
-    
-    void printProgressBar(double value, double max_value, int width) {
-        double percent = value / max_value;
-        int filled = static_cast<int>(percent * width);
-        
-        std::cout << "\033[1;32m["; // Зеленый для прогресс-бара
-        for (int i = 0; i < width; ++i) {
-            if (i < filled) {
-                std::cout << "█";
-            } else {
-                std::cout << " ";
-            }
+    loop.unwatch(sampler.notifyFd());
+    loop.unwatch(keyboard.fd());
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Пакетный режим: без терминала, каждый тик сериализуется в stdout или файл
+int runBatch(EventLoop& loop, SystemInfo& sysInfo, const MtopConfig& config, SessionRecorder* recorder) {
+    int fd = STDOUT_FILENO;
+    if (!config.output_file.empty()) {
+        fd = open(config.output_file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Error: cannot open " << config.output_file << ": " << strerror(errno) << "\n";
+            return 1;
         }
-        std::cout << "]\033[0m";
     }
     
-    std::string formatBytes(uint64_t bytes) {
-        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
-        int unit_index = 0;
-        double size = static_cast<double>(bytes);
+    StatsSerializer serializer(config.output_format);
+    int samples = 0;
+    
+    // Первый замер сделан в конструкторе SystemInfo - ждем интервал, чтобы CPU% был осмысленным
+    loop.setInterval(config.update_interval, config.update_interval);
+    
+    int ready_fd;
+    while (config.iterations <= 0 || samples < config.iterations) {
+        EventLoop::Event event = loop.wait(ready_fd);
+        if (event == EventLoop::Event::Resize) continue;
+        if (event != EventLoop::Event::Tick) break;
+        
+        sysInfo.updateStats();
+        std::shared_ptr<const SystemStats> stats = sysInfo.getStats();
         
-        while (size >= 1024.0 && unit_index < 4) {
-            size /= 1024.0;
-            unit_index++;
+        double timestamp = currentTimestamp();
+        if (recorder && !recorder->append(*stats, timestamp)) {
+            std::cerr << "Warning: recording stopped: " << recorder->error() << "\n";
+            recorder = nullptr;
         }
         
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(1) << size << units[unit_index];
-        return oss.str();
+        serializer.clear();
+        serializer.append(*stats, timestamp);
+        if (!writeAll(fd, serializer.data())) {
+            std::cerr << "Error: write failed: " << strerror(errno) << "\n";
+            break;
+        }
+        samples++;
     }
-};
-
-volatile bool running = true;
+    
+    if (fd != STDOUT_FILENO) {
+        close(fd);
+    }
+    return 0;
+}
 
-void signalHandler(int signal) {
-    running = false;
+// Воспроизведение записи через тот же Display: пробел - пауза, стрелки - перемотка на 10 с
+int runReplay(EventLoop& loop, const MtopConfig& config) {
+    SessionPlayer player;
+    std::string error;
+    if (!player.open(config.replay_file, error)) {
+        std::cerr << "Error: cannot replay " << config.replay_file << ": " << error << "\n";
+        return 1;
+    }
+    
+    double speed = config.replay_speed > 0 ? config.replay_speed : 1.0;
+    player.seek(player.startTime() + config.replay_seek);
+    
+    Display display(config);
+    Keyboard keyboard;
+    if (keyboard.isActive()) {
+        loop.watch(keyboard.fd());
+    }
+    
+    SystemStats stats;
+    double timestamp = 0;
+    bool paused = false;
+    
+    auto showFrame = [&]() {
+        char when[32];
+        time_t seconds = static_cast<time_t>(timestamp);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &local);
+        
+        char status[160];
+        snprintf(status, sizeof(status), "%sReplay %s | x%.2g | frame %zu/%zu | space pause  <-/-> seek 10s  q quit",
+                 paused ? "PAUSED | " : "", when, speed, player.position(), player.frameCount());
+        display.setStatusLine(status);
+        display.render(stats);
+    };
+    
+    // Пауза до следующего кадра как при записи, с учетом скорости; false - запись кончилась
+    auto scheduleNext = [&]() {
+        double next_timestamp;
+        if (!player.peekTimestamp(next_timestamp)) return false;
+        double delay = std::max(0.0, next_timestamp - timestamp) / speed;
+        loop.setTimeout(std::min(delay, 60.0));
+        return true;
+    };
+    
+    if (!player.next(stats, timestamp)) return 0;
+    showFrame();
+    bool running = scheduleNext();
+    
+    std::vector<int> keys;
+    int ready_fd;
+    while (running) {
+        EventLoop::Event event = loop.wait(ready_fd);
+        
+        if (event == EventLoop::Event::Resize) {
+            showFrame();
+        } else if (event == EventLoop::Event::Tick) {
+            if (paused || !player.next(stats, timestamp)) continue;
+            showFrame();
+            running = scheduleNext();
+        } else if (event == EventLoop::Event::Input && ready_fd == keyboard.fd()) {
+            keys.clear();
+            if (!keyboard.read(keys)) {
+                loop.unwatch(keyboard.fd());
+            }
+            for (int key : keys) {
+                if (key == 'q' || key == 'Q') {
+                    running = false;
+                    break;
+                }
+                
+                if (key == ' ') {
+                    paused = !paused;
+                } else if (key == Keyboard::Left || key == Keyboard::Right) {
+                    // seek() встает на кадр не позже заданного времени; декодируем его сразу
+                    player.seek(timestamp + (key == Keyboard::Left ? -10.0 : 10.0));
+                    player.next(stats, timestamp);
+                } else {
+                    continue;
+                }
+                
+                if (paused) {
+                    loop.stopTimer();
+                } else {
+                    scheduleNext();
+                }
+                showFrame();
+            }
+        } else {
+            break;
+        }
+    }
+    
+    loop.unwatch(keyboard.fd());
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
@@ -194,35 +459,54 @@ int main(int argc, char* argv[]) {
     
     MtopConfig config = parser.getConfig();
     
-    // Настройка обработки сигналов
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
+    // Сигналы приходят через signalfd; открываем до SystemInfo, который запускает потоки
+    EventLoop loop;
+    std::string loop_error;
+    if (!loop.open(loop_error)) {
+        std::cerr << "Error: cannot set up event loop: " << loop_error << "\n";
+        return 1;
+    }
+    
+    if (!config.replay_file.empty()) {
+        return runReplay(loop, config);
+    }
+    
+    std::unique_ptr<SessionRecorder> recorder;
+    if (!config.record_file.empty()) {
+        std::string error;
+        recorder = std::make_unique<SessionRecorder>();
+        if (!recorder->open(config.record_file, error)) {
+            std::cerr << "Error: cannot record to " << config.record_file << ": " << error << "\n";
+            return 1;
+        }
+    }
     
     SystemInfo sysInfo(config);
-    Display display(config);
+    if (!sysInfo.procEventsError().empty()) {
+        std::cerr << "Warning: " << sysInfo.procEventsError() << "; scanning /proc instead\n";
+    }
+    if (!sysInfo.collectorError().empty()) {
+        std::cerr << "Warning: " << sysInfo.collectorError() << "; reading /proc/PID/stat instead\n";
+    }
+    if (!sysInfo.cgroupError().empty()) {
+        std::cerr << "Warning: " << sysInfo.cgroupError() << "; showing processes instead\n";
+    }
+    if (!sysInfo.filterError().empty()) {
+        std::cerr << "Warning: " << sysInfo.filterError() << " (expected e.g. cpu>5, mem>1G, state=D)\n";
+    }
     
-    std::cout << "\033[1;32mStarting mtop... Press Ctrl+C to exit\033[0m\n";
-
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (config.batch_mode) {
+        return runBatch(loop, sysInfo, config, recorder.get());
+    }
     
-    while (running) {
-        system("clear");
-        if (config.header) { display.printHeader(); }
-        
-        sysInfo.updateStats();
-        SystemStats stats = sysInfo.getStats();
-        
-        display.printSystemStats(stats);
-        display.printProcesses(stats);
-        
-        std::cout << "\n\033[1;90mPress Ctrl+C to exit | Update interval: " 
-                    << config.update_interval << "s\033[0m" << std::flush;
-        
-        // Обновляем согласно интервалу из конфигурации
-        std::this_thread::sleep_for(std::chrono::seconds(config.update_interval));
+    std::cout << "\033[1;32mStarting mtop... Press Ctrl+C to exit\033[0m\n" << std::flush;
+    
+    runInteractive(loop, sysInfo, config, recorder.get());
+    if (recorder && !recorder->error().empty()) {
+        std::cerr << "Warning: recording stopped: " << recorder->error() << "\n";
     }
     
-    std::cout << "\n\033[1;32mGoodbye!\033[0m\n";
+    std::cout << "\033[1;32mGoodbye!\033[0m\n";
     
     return 0;
 }
\ No newline at end of file
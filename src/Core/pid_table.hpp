@@ -0,0 +1,136 @@
+#ifndef PID_TABLE_HPP
+#define PID_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Flat open-addressing hash map keyed by PID (linear probing, backward-shift
+// deletion). Slots are reused between ticks, so a steady-state process table
+// does not allocate. PID 0 never appears in /proc and marks an empty slot.
+template <typename T>
+class PidTable {
+public:
+    explicit PidTable(size_t initial_capacity = 1024) {
+        size_t capacity = 16;
+        while (capacity < initial_capacity) capacity <<= 1;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    size_t size() const { return count; }
+
+    T* find(int pid) {
+        for (size_t i = slotFor(pid);; i = (i + 1) & mask) {
+            if (slots[i].pid == pid) return &slots[i].value;
+            if (slots[i].pid == 0) return nullptr;
+        }
+    }
+
+    // Returns the entry for pid, inserting a default-constructed one if needed
+    T& insert(int pid, bool& inserted) {
+        if ((count + 1) * 2 > slots.size()) grow();
+
+        size_t i = slotFor(pid);
+        while (slots[i].pid != 0) {
+            if (slots[i].pid == pid) {
+                inserted = false;
+                return slots[i].value;
+            }
+            i = (i + 1) & mask;
+        }
+
+        slots[i].pid = pid;
+        slots[i].value = T();
+        count++;
+        inserted = true;
+        return slots[i].value;
+    }
+
+    bool erase(int pid) {
+        for (size_t i = slotFor(pid);; i = (i + 1) & mask) {
+            if (slots[i].pid == 0) return false;
+            if (slots[i].pid == pid) {
+                eraseSlot(i);
+                return true;
+            }
+        }
+    }
+
+    // Removes every entry for which keep(pid, value) returns false
+    template <typename Pred>
+    void sweep(Pred keep) {
+        size_t i = 0;
+        while (i < slots.size()) {
+            if (slots[i].pid != 0 && !keep(slots[i].pid, slots[i].value)) {
+                // Backward shift may pull a later entry into slot i, recheck it
+                eraseSlot(i);
+                continue;
+            }
+            i++;
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (auto& slot : slots) {
+            if (slot.pid != 0) fn(slot.pid, slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        int pid = 0;
+        T value{};
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+    size_t slotFor(int pid) const {
+        // Fibonacci hashing: consecutive PIDs spread across the table
+        return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(pid)) *
+                                    0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    void eraseSlot(size_t hole) {
+        size_t i = hole;
+        for (;;) {
+            i = (i + 1) & mask;
+            if (slots[i].pid == 0) break;
+
+            // Entry may move into the hole only if its home slot is not
+            // cyclically within (hole, i]
+            size_t home = slotFor(slots[i].pid);
+            bool movable = (i > hole) ? (home <= hole || home > i)
+                                      : (home <= hole && home > i);
+            if (movable) {
+                slots[hole] = std::move(slots[i]);
+                hole = i;
+            }
+        }
+        slots[hole].pid = 0;
+        slots[hole].value = T();
+        count--;
+    }
+
+    void grow() {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(old.size() * 2);
+        mask = slots.size() - 1;
+        count = 0;
+
+        for (auto& slot : old) {
+            if (slot.pid == 0) continue;
+            size_t i = slotFor(slot.pid);
+            while (slots[i].pid != 0) i = (i + 1) & mask;
+            slots[i] = std::move(slot);
+            count++;
+        }
+    }
+};
+
+#endif // PID_TABLE_HPP
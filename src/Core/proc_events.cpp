@@ -0,0 +1,326 @@
+#include "proc_events.hpp"
+#include "proc_parser.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// Коды событий из linux/cn_proc.h (ABI ядра). В новых заголовках enum вынесен
+// из struct proc_event, поэтому сравниваем с числами, а не с именами
+constexpr uint32_t event_none = 0x00000000;
+constexpr uint32_t event_fork = 0x00000001;
+constexpr uint32_t event_exec = 0x00000002;
+constexpr uint32_t event_comm = 0x00000200;
+constexpr uint32_t event_exit = 0x80000000;
+
+} // namespace
+
+ProcEvents::ProcEvents()
+    : sock_fd(-1), stop_fd(-1), pending_count(0), lost(false), resyncing(false), list_limit(0),
+      short_lived_count(0), buffer(1 << 16) {
+}
+
+ProcEvents::~ProcEvents() {
+    close();
+}
+
+bool ProcEvents::open(std::string& error) {
+    if (isOpen()) return true;
+
+    sock_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+    if (sock_fd < 0) {
+        error = std::string("netlink socket: ") + strerror(errno);
+        return false;
+    }
+
+    // Всплеск fork() должен поместиться в буфер сокета, пока поток читателя занят
+    int rcvbuf = 8 << 20;
+    if (setsockopt(sock_fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) != 0) {
+        setsockopt(sock_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    struct sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    if (bind(sock_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        error = std::string("netlink bind: ") + strerror(errno);
+        close();
+        return false;
+    }
+
+    if (!subscribe(PROC_CN_MCAST_LISTEN)) {
+        error = std::string("proc connector: ") + strerror(errno);
+        close();
+        return false;
+    }
+
+    // Ядро подтверждает подписку событием PROC_EVENT_NONE с кодом ошибки.
+    // Без CAP_NET_ADMIN приходит EPERM, вне начального namespace - ничего
+    bool acknowledged = false;
+    struct pollfd pfd = {sock_fd, POLLIN, 0};
+    while (!acknowledged && poll(&pfd, 1, 500) > 0) {
+        ssize_t len = recv(sock_fd, buffer.data(), buffer.size(), 0);
+        if (len <= 0) break;
+
+        const auto* header = reinterpret_cast<const struct nlmsghdr*>(buffer.data());
+        if (!NLMSG_OK(header, static_cast<size_t>(len))) continue;
+        const auto* msg = static_cast<const struct cn_msg*>(NLMSG_DATA(header));
+
+        struct proc_event event = {};
+        memcpy(&event, msg->data, std::min<size_t>(msg->len, sizeof(event)));
+        if (static_cast<uint32_t>(event.what) != event_none) continue;
+
+        if (event.event_data.ack.err != 0) {
+            error = std::string("proc connector: ") + strerror(static_cast<int>(event.event_data.ack.err));
+            close();
+            return false;
+        }
+        acknowledged = true;
+    }
+
+    if (!acknowledged) {
+        error = "proc connector: no acknowledgement (not in the initial namespace?)";
+        close();
+        return false;
+    }
+
+    stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (stop_fd < 0) {
+        error = std::string("eventfd: ") + strerror(errno);
+        close();
+        return false;
+    }
+    reader = std::thread(&ProcEvents::run, this);
+    return true;
+}
+
+void ProcEvents::close() {
+    if (reader.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = write(stop_fd, &one, sizeof(one));
+        (void)written;
+        reader.join();
+    }
+    if (stop_fd >= 0) {
+        ::close(stop_fd);
+        stop_fd = -1;
+    }
+    if (sock_fd >= 0) {
+        subscribe(PROC_CN_MCAST_IGNORE);
+        ::close(sock_fd);
+        sock_fd = -1;
+    }
+}
+
+bool ProcEvents::subscribe(int op) {
+    alignas(struct nlmsghdr) char msg[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(int))] = {};
+
+    auto* header = reinterpret_cast<struct nlmsghdr*>(msg);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(int));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = 0;
+
+    auto* cn = static_cast<struct cn_msg*>(NLMSG_DATA(header));
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(int);
+    memcpy(cn->data, &op, sizeof(op));
+
+    return send(sock_fd, msg, header->nlmsg_len, 0) >= 0;
+}
+
+void ProcEvents::run() {
+    struct pollfd fds[2] = {{sock_fd, POLLIN, 0}, {stop_fd, POLLIN, 0}};
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents & POLLIN) return;
+
+        while (true) {
+            ssize_t len = recv(sock_fd, buffer.data(), buffer.size(), 0);
+            if (len > 0) {
+                handleMessage(buffer.data(), static_cast<size_t>(len));
+                continue;
+            }
+            if (len < 0 && errno == EINTR) continue;
+            // ENOBUFS: ядро отбросило события, живое множество больше не точное
+            if (len < 0 && errno == ENOBUFS) {
+                std::lock_guard<std::mutex> lock(mutex);
+                lost = true;
+                continue;
+            }
+            break;
+        }
+    }
+}
+
+bool ProcEvents::drain() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    short_lived_count = pending_count;
+    short_lived.swap(pending);
+    pending_count = 0;
+    pending.clear();
+
+    // Процессы, родившиеся в этом интервале и еще живые, попадут в скан
+    births.clear();
+
+    bool complete = !lost;
+    lost = false;
+    return complete;
+}
+
+void ProcEvents::handleMessage(const char* data, size_t size) {
+    struct Event {
+        struct proc_event event;
+        std::string comm;
+    };
+    std::vector<Event> events;
+    bool want_names = list_limit.load(std::memory_order_relaxed) > 0;
+
+    // Разбор и чтение имен - без блокировки: drain() не ждет файловой системы
+    const auto* header = reinterpret_cast<const struct nlmsghdr*>(data);
+    for (; NLMSG_OK(header, size); header = NLMSG_NEXT(header, size)) {
+        if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) continue;
+
+        const auto* msg = static_cast<const struct cn_msg*>(NLMSG_DATA(header));
+        // Данные события не выровнены по 8 байт - копируем перед чтением
+        Event item = {};
+        memcpy(&item.event, msg->data, std::min<size_t>(msg->len, sizeof(item.event)));
+
+        // Событие COMM ядро шлет только на prctl(PR_SET_NAME), не на exec() -
+        // имя после exec() читаем сразу, пока процесс еще существует
+        uint32_t what = static_cast<uint32_t>(item.event.what);
+        if (what == event_exec && want_names) {
+            const auto& exec_event = item.event.event_data.exec;
+            char path[64];
+            if (exec_event.process_pid == exec_event.process_tgid &&
+                formatProcPath(path, sizeof(path), exec_event.process_tgid, "comm")) {
+                int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+                if (fd >= 0) {
+                    char comm[64];
+                    ssize_t len = read(fd, comm, sizeof(comm));
+                    ::close(fd);
+                    if (len > 0 && comm[len - 1] == '\n') len--;
+                    if (len > 0) item.comm.assign(comm, static_cast<size_t>(len));
+                }
+            }
+        }
+        if (what == event_fork || what == event_exec || what == event_comm || what == event_exit) {
+            events.push_back(std::move(item));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t limit = list_limit.load(std::memory_order_relaxed);
+
+    for (auto& item : events) {
+        const struct proc_event& event = item.event;
+
+        switch (static_cast<uint32_t>(event.what)) {
+            case event_fork: {
+                const auto& fork_event = event.event_data.fork;
+                // Потоки (pid != tgid) в список процессов не входят
+                if (fork_event.child_pid != fork_event.child_tgid) break;
+                bool inserted;
+                live.insert(fork_event.child_tgid, inserted);
+                if (resyncing) resync_changes.push_back(Change{fork_event.child_tgid, true});
+
+                // До exec() у потомка имя родителя; если родитель тоже новый, оно уже известно
+                Birth birth{fork_event.parent_tgid, event.timestamp_ns, std::string()};
+                auto parent = births.find(fork_event.parent_tgid);
+                if (parent != births.end()) birth.name = parent->second.name;
+                births[fork_event.child_tgid] = std::move(birth);
+                break;
+            }
+            case event_exec: {
+                const auto& exec_event = event.event_data.exec;
+                auto it = births.find(exec_event.process_tgid);
+                if (it != births.end() && !item.comm.empty()) {
+                    it->second.name = std::move(item.comm);
+                }
+                break;
+            }
+            case event_comm: {
+                const auto& comm_event = event.event_data.comm;
+                if (comm_event.process_pid != comm_event.process_tgid) break;
+                auto it = births.find(comm_event.process_tgid);
+                if (it != births.end()) {
+                    it->second.name.assign(comm_event.comm, strnlen(comm_event.comm, sizeof(comm_event.comm)));
+                }
+                break;
+            }
+            case event_exit: {
+                const auto& exit_event = event.event_data.exit;
+                if (exit_event.process_pid != exit_event.process_tgid) break;
+                live.erase(exit_event.process_tgid);
+                if (resyncing) resync_changes.push_back(Change{exit_event.process_tgid, false});
+
+                auto it = births.find(exit_event.process_tgid);
+                if (it == births.end()) break;
+
+                pending_count++;
+                if (pending.size() < limit) {
+                    double lifetime_ms = event.timestamp_ns > it->second.timestamp_ns
+                                             ? (event.timestamp_ns - it->second.timestamp_ns) / 1e6 : 0.0;
+                    pending.push_back(ShortLivedProcess{exit_event.process_tgid, it->second.ppid,
+                                                        std::move(it->second.name),
+                                                        static_cast<int>(exit_event.exit_code), lifetime_ms});
+                }
+                births.erase(it);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+void ProcEvents::beginResync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    resyncing = true;
+    resync_changes.clear();
+}
+
+void ProcEvents::resync(const std::vector<int>& pids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    live = PidTable<bool>();
+    for (int pid : pids) {
+        bool inserted;
+        live.insert(pid, inserted);
+    }
+
+    // Листинг мог не застать процесс, родившийся во время обхода, или застать
+    // уже завершившийся - события с начала обхода накладываем поверх по порядку
+    for (const Change& change : resync_changes) {
+        if (change.alive) {
+            bool inserted;
+            live.insert(change.pid, inserted);
+        } else {
+            live.erase(change.pid);
+        }
+    }
+    resyncing = false;
+    resync_changes.clear();
+}
+
+void ProcEvents::livePids(std::vector<int>& pids) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pids.clear();
+    pids.reserve(live.size());
+    live.forEach([&pids](int pid, bool&) {
+        pids.push_back(pid);
+    });
+}
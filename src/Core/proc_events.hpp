@@ -0,0 +1,98 @@
+#ifndef PROC_EVENTS_HPP
+#define PROC_EVENTS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "pid_table.hpp"
+
+// A process that was forked and exited between two drains, so no scan
+// ever saw it
+struct ShortLivedProcess {
+    int pid;
+    int ppid;
+    std::string name; // read at exec (or inherited from a new parent); may be empty
+    int exit_code;    // raw wait status
+    double lifetime_ms;
+};
+
+// Live PID set fed by the netlink proc connector (PROC_EVENT_FORK/EXEC/EXIT)
+// instead of listing /proc every tick. A reader thread applies events as
+// they arrive, so exec'd names can be read while the process still exists;
+// drain() marks the tick boundary. Needs CAP_NET_ADMIN in the initial
+// namespaces; open() fails otherwise and the caller keeps scanning /proc.
+class ProcEvents {
+public:
+    ProcEvents();
+    ~ProcEvents();
+
+    ProcEvents(const ProcEvents&) = delete;
+    ProcEvents& operator=(const ProcEvents&) = delete;
+
+    // Subscribes and waits for the kernel's acknowledgement
+    bool open(std::string& error);
+    void close();
+    bool isOpen() const { return sock_fd >= 0; }
+
+    // Ends the current interval. Returns false if events were dropped
+    // (receive buffer overflow); the live set is then stale until resync().
+    bool drain();
+
+    // Rebuilding the live set from /proc: call beginResync(), list /proc,
+    // then resync() with the listing. Forks and exits that arrive from
+    // beginResync() on are replayed over the listing, so a process that
+    // starts or exits while /proc is read is neither lost nor kept.
+    void beginResync();
+    void resync(const std::vector<int>& pids);
+
+    void livePids(std::vector<int>& pids);
+
+    // Processes born and gone during the last drained interval
+    int shortLivedCount() const { return short_lived_count; }
+    const std::vector<ShortLivedProcess>& shortLived() const { return short_lived; }
+    void setListLimit(size_t limit) { list_limit.store(limit, std::memory_order_relaxed); }
+
+private:
+    struct Birth {
+        int ppid;
+        uint64_t timestamp_ns;
+        std::string name;
+    };
+
+    struct Change {
+        int pid;
+        bool alive; // fork, or exit if false
+    };
+
+    int sock_fd;
+    int stop_fd; // eventfd waking the reader thread for shutdown
+    std::thread reader;
+
+    // Shared with the reader thread
+    std::mutex mutex;
+    PidTable<bool> live;
+    std::unordered_map<int, Birth> births; // forked since the previous drain
+    int pending_count;
+    std::vector<ShortLivedProcess> pending;
+    bool lost;
+    bool resyncing;                  // between beginResync() and resync()
+    std::vector<Change> resync_changes;
+    std::atomic<size_t> list_limit;
+
+    // Results of the last drain(), owned by the caller's thread
+    int short_lived_count;
+    std::vector<ShortLivedProcess> short_lived;
+
+    std::vector<char> buffer; // reader thread only
+
+    bool subscribe(int op);
+    void run();
+    void handleMessage(const char* data, size_t size);
+};
+
+#endif // PROC_EVENTS_HPP
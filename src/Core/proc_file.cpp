@@ -0,0 +1,41 @@
+#include "proc_file.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+ssize_t preadFile(int fd, char* buf, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = pread(fd, buf + total, size - total, static_cast<off_t>(total));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(total);
+}
+
+ProcFile::ProcFile(const char* path) : fd(open(path, O_RDONLY | O_CLOEXEC)) {
+}
+
+ProcFile::~ProcFile() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+ssize_t ProcFile::read(std::vector<char>& buf) {
+    if (fd < 0) return -1;
+    if (buf.empty()) buf.resize(4096);
+
+    while (true) {
+        ssize_t len = preadFile(fd, buf.data(), buf.size());
+        if (len < 0) return -1;
+
+        // Буфер заполнен целиком - файл мог не поместиться, увеличиваем
+        if (static_cast<size_t>(len) < buf.size()) return len;
+        buf.resize(buf.size() * 2);
+    }
+}
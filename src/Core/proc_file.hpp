@@ -0,0 +1,33 @@
+#ifndef PROC_FILE_HPP
+#define PROC_FILE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <sys/types.h>
+
+// Reads a whole file with pread() from offset 0. procfs seq files regenerate
+// their contents on every read at offset 0, so an fd can be kept open and
+// re-read each tick. Returns the number of bytes read, or -1 on error
+// (errno is preserved, ESRCH means the process is gone).
+ssize_t preadFile(int fd, char* buf, size_t size);
+
+// A procfs file kept open between ticks (/proc/stat, /proc/meminfo, ...)
+class ProcFile {
+public:
+    explicit ProcFile(const char* path);
+    ~ProcFile();
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Re-reads the file into buf, growing it until the contents fit.
+    // Returns the length of the contents, or -1 on error.
+    ssize_t read(std::vector<char>& buf);
+
+private:
+    int fd;
+};
+
+#endif // PROC_FILE_HPP
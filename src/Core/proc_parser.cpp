@@ -0,0 +1,452 @@
+#include "proc_parser.hpp"
+#include <charconv>
+#include <iterator>
+#include <system_error>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+namespace {
+
+template <typename T>
+bool parseNumber(const char* begin, const char* end, T& value) {
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+} // namespace
+
+bool parseProcStat(const char* data, size_t len, ProcStat& out) {
+    // Имя процесса может содержать пробелы и скобки, поэтому ищем последнюю ')'
+    const char* open_paren = static_cast<const char*>(memchr(data, '(', len));
+    const char* close_paren = nullptr;
+    for (const char* p = data + len; p > data; --p) {
+        if (p[-1] == ')') {
+            close_paren = p - 1;
+            break;
+        }
+    }
+
+    if (!open_paren || !close_paren || close_paren < open_paren) {
+        return false;
+    }
+
+    out.comm = std::string_view(open_paren + 1, close_paren - open_paren - 1);
+
+    // Поля после имени нумеруются с 3 (state), как в proc(5)
+    const char* end = data + len;
+    const char* p = close_paren + 1;
+    int field = 3;
+
+    while (p < end && field <= 24) {
+        while (p < end && *p == ' ') ++p;
+        const char* token = p;
+        while (p < end && *p != ' ' && *p != '\n') ++p;
+        if (token == p) break;
+
+        bool ok = true;
+        switch (field) {
+            case 3:  out.state = *token; break;
+            case 4:  ok = parseNumber(token, p, out.ppid); break;
+            case 14: ok = parseNumber(token, p, out.utime); break;
+            case 15: ok = parseNumber(token, p, out.stime); break;
+            case 19: ok = parseNumber(token, p, out.nice); break;
+            case 20: ok = parseNumber(token, p, out.num_threads); break;
+            case 22: ok = parseNumber(token, p, out.starttime); break;
+            case 23: ok = parseNumber(token, p, out.vsize); break;
+            case 24: ok = parseNumber(token, p, out.rss); break;
+            default: break;
+        }
+        if (!ok) return false;
+        field++;
+    }
+
+    return field > 24;
+}
+
+namespace {
+
+template <typename T>
+const char* parseNext(const char* p, const char* end, T& value) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    auto result = std::from_chars(p, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+} // namespace
+
+const char* parseNextNumber(const char* p, const char* end, uint64_t& value) {
+    return parseNext(p, end, value);
+}
+
+const char* parseNextNumber(const char* p, const char* end, double& value) {
+    return parseNext(p, end, value);
+}
+
+namespace {
+
+// Разбирает числа строки в поля CPU; недостающие остаются нулями
+template <typename Store>
+void parseCpuFields(const char* p, const char* eol, Store store) {
+    for (int field = 0; field < CpuTimes::FIELD_COUNT; ++field) {
+        uint64_t value = 0;
+        if (p) p = parseNextNumber(p, eol, value);
+        store(field, p ? value : 0);
+    }
+}
+
+bool startsWith(const char* p, const char* end, std::string_view prefix) {
+    return static_cast<size_t>(end - p) >= prefix.size() && memcmp(p, prefix.data(), prefix.size()) == 0;
+}
+
+} // namespace
+
+bool parseKernelStat(const char* data, size_t len, KernelStat& out) {
+    out.cores.ids.clear();
+    for (auto& field : out.cores.fields) {
+        field.clear();
+    }
+    bool found_cpu = false;
+
+    const char* p = data;
+    const char* end = data + len;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        if (startsWith(p, eol, "cpu ")) {
+            parseCpuFields(p + 3, eol, [&out](int field, uint64_t value) {
+                out.cpu[field] = value;
+            });
+            found_cpu = true;
+        } else if (startsWith(p, eol, "cpu")) {
+            int id = 0;
+            auto result = std::from_chars(p + 3, eol, id);
+            if (result.ec == std::errc()) {
+                out.cores.ids.push_back(id);
+                parseCpuFields(result.ptr, eol, [&out](int field, uint64_t value) {
+                    out.cores.fields[field].push_back(value);
+                });
+            }
+        } else if (startsWith(p, eol, "intr ")) {
+            // Первое число - сумма; тысячи счетчиков по IRQ за ним не разбираем
+            parseNextNumber(p + 5, eol, out.interrupts);
+        } else if (startsWith(p, eol, "ctxt ")) {
+            parseNextNumber(p + 5, eol, out.context_switches);
+        } else if (startsWith(p, eol, "processes ")) {
+            parseNextNumber(p + 10, eol, out.forks);
+        } else if (startsWith(p, eol, "procs_running ")) {
+            parseNextNumber(p + 14, eol, out.procs_running);
+        } else if (startsWith(p, eol, "procs_blocked ")) {
+            parseNextNumber(p + 14, eol, out.procs_blocked);
+        }
+
+        p = eol + 1;
+    }
+
+    return found_cpu;
+}
+
+namespace {
+
+// Ключ файла вида "Key:   value kB" и поле структуры, куда он попадает
+template <typename T>
+struct KeyField {
+    std::string_view name;
+    uint64_t T::*field;
+};
+
+// Один проход по строкам "Key: value" против таблицы ключей; останавливается,
+// как только найдены все. Возвращает число найденных ключей
+template <typename T, size_t N>
+size_t parseKeyTable(const char* data, size_t len, const KeyField<T> (&keys)[N], T& out) {
+    size_t found = 0;
+
+    const char* p = data;
+    const char* end = data + len;
+    while (p < end && found < N) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        const char* colon = static_cast<const char*>(memchr(p, ':', eol - p));
+        if (colon) {
+            std::string_view key(p, static_cast<size_t>(colon - p));
+            for (const auto& entry : keys) {
+                if (entry.name == key) {
+                    parseNextNumber(colon + 1, eol, out.*entry.field);
+                    found++;
+                    break;
+                }
+            }
+        }
+
+        p = eol + 1;
+    }
+
+    return found;
+}
+
+// Ключи /proc/meminfo, которые нужны, и поля, куда они попадают
+const KeyField<MemInfo> meminfo_keys[] = {
+    {"MemTotal", &MemInfo::total_kb},
+    {"MemFree", &MemInfo::free_kb},
+    {"MemAvailable", &MemInfo::available_kb},
+    {"Buffers", &MemInfo::buffers_kb},
+    {"Cached", &MemInfo::cached_kb},
+    {"SwapTotal", &MemInfo::swap_total_kb},
+    {"SwapFree", &MemInfo::swap_free_kb},
+    {"Dirty", &MemInfo::dirty_kb},
+    {"Writeback", &MemInfo::writeback_kb},
+    {"Shmem", &MemInfo::shmem_kb},
+    {"Slab", &MemInfo::slab_kb},
+    {"HugePages_Total", &MemInfo::hugepages_total},
+    {"HugePages_Free", &MemInfo::hugepages_free},
+    {"Hugepagesize", &MemInfo::hugepage_size_kb},
+};
+
+// Первая строка smaps_rollup - заголовок "00400000-7fff... ---p 00000000 00:00 0 [rollup]"
+const KeyField<SmapsRollup> smaps_keys[] = {
+    {"Rss", &SmapsRollup::rss_kb},
+    {"Pss", &SmapsRollup::pss_kb},
+    {"Private_Clean", &SmapsRollup::private_clean_kb},
+    {"Private_Dirty", &SmapsRollup::private_dirty_kb},
+    {"Private_Hugetlb", &SmapsRollup::private_hugetlb_kb},
+    {"Swap", &SmapsRollup::swap_kb},
+};
+
+const KeyField<ProcIo> io_keys[] = {
+    {"rchar", &ProcIo::rchar},
+    {"wchar", &ProcIo::wchar},
+    {"syscr", &ProcIo::syscr},
+    {"syscw", &ProcIo::syscw},
+    {"read_bytes", &ProcIo::read_bytes},
+    {"write_bytes", &ProcIo::write_bytes},
+    {"cancelled_write_bytes", &ProcIo::cancelled_write_bytes},
+};
+
+} // namespace
+
+bool parseMemInfo(const char* data, size_t len, MemInfo& out) {
+    out = MemInfo();
+    parseKeyTable(data, len, meminfo_keys, out);
+    return out.total_kb > 0;
+}
+
+bool parseSmapsRollup(const char* data, size_t len, SmapsRollup& out) {
+    out = SmapsRollup();
+    return parseKeyTable(data, len, smaps_keys, out) > 0;
+}
+
+bool parseProcIo(const char* data, size_t len, ProcIo& out) {
+    out = ProcIo();
+    // Без task I/O accounting в ядре read_bytes/write_bytes отсутствуют
+    return parseKeyTable(data, len, io_keys, out) >= 4;
+}
+
+bool parsePressure(const char* data, size_t len, PressureInfo& out) {
+    out = PressureInfo();
+    bool found = false;
+
+    // "some avg10=0.00 avg60=0.00 avg300=0.00 total=0", затем такая же строка "full"
+    const char* p = data;
+    const char* end = data + len;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        bool some = startsWith(p, eol, "some ");
+        if (some || startsWith(p, eol, "full ")) {
+            double* averages = some ? out.some : out.full;
+            uint64_t& total = some ? out.some_total : out.full_total;
+
+            const char* q = p + 5;
+            for (int i = 0; i < 3 && q; ++i) {
+                q = static_cast<const char*>(memchr(q, '=', eol - q));
+                if (q) q = parseNextNumber(q + 1, eol, averages[i]);
+            }
+            if (q) q = static_cast<const char*>(memchr(q, '=', eol - q));
+            if (q) parseNextNumber(q + 1, eol, total);
+            found = true;
+        }
+
+        p = eol + 1;
+    }
+
+    return found;
+}
+
+bool parseProcCgroup(const char* data, size_t len, std::string_view& path) {
+    // В гибридном режиме рядом строки v1 "N:controller:/path"; нужна строка с иерархией 0
+    const char* p = data;
+    const char* end = data + len;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        if (startsWith(p, eol, "0::")) {
+            path = std::string_view(p + 3, static_cast<size_t>(eol - p - 3));
+            return !path.empty();
+        }
+
+        p = eol + 1;
+    }
+    return false;
+}
+
+bool parseCgroupCpuStat(const char* data, size_t len, uint64_t& usage_usec) {
+    // usage_usec - первая строка, но порядок ключей не гарантирован
+    const char* p = data;
+    const char* end = data + len;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+
+        if (startsWith(p, eol, "usage_usec ")) {
+            return parseNextNumber(p + 11, eol, usage_usec) != nullptr;
+        }
+
+        p = eol + 1;
+    }
+    return false;
+}
+
+void computeCpuPercents(const CpuTimes& now, const CpuTimes& before, std::vector<float>& percents) {
+    size_t n = now.size();
+    percents.resize(n);
+
+    const uint64_t* user = now.fields[CpuTimes::USER].data();
+    const uint64_t* nice = now.fields[CpuTimes::NICE].data();
+    const uint64_t* system = now.fields[CpuTimes::SYSTEM].data();
+    const uint64_t* idle = now.fields[CpuTimes::IDLE].data();
+    const uint64_t* iowait = now.fields[CpuTimes::IOWAIT].data();
+    const uint64_t* irq = now.fields[CpuTimes::IRQ].data();
+    const uint64_t* softirq = now.fields[CpuTimes::SOFTIRQ].data();
+    const uint64_t* steal = now.fields[CpuTimes::STEAL].data();
+    const uint64_t* prev_user = before.fields[CpuTimes::USER].data();
+    const uint64_t* prev_nice = before.fields[CpuTimes::NICE].data();
+    const uint64_t* prev_system = before.fields[CpuTimes::SYSTEM].data();
+    const uint64_t* prev_idle = before.fields[CpuTimes::IDLE].data();
+    const uint64_t* prev_iowait = before.fields[CpuTimes::IOWAIT].data();
+    const uint64_t* prev_irq = before.fields[CpuTimes::IRQ].data();
+    const uint64_t* prev_softirq = before.fields[CpuTimes::SOFTIRQ].data();
+    const uint64_t* prev_steal = before.fields[CpuTimes::STEAL].data();
+    float* out = percents.data();
+
+    // Дельты в полных 64 битах: после долгого простоя или паузы интервал
+    // может быть любым. iowait может уменьшаться - отрицательную сумму
+    // (разность в дополнительном коде) обнуляем
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t busy = (user[i] - prev_user[i]) + (nice[i] - prev_nice[i]) + (system[i] - prev_system[i]) +
+                        (irq[i] - prev_irq[i]) + (softirq[i] - prev_softirq[i]) + (steal[i] - prev_steal[i]);
+        uint64_t waiting = (idle[i] - prev_idle[i]) + (iowait[i] - prev_iowait[i]);
+        int64_t busy_delta = static_cast<int64_t>(busy);
+        int64_t waiting_delta = static_cast<int64_t>(waiting);
+        busy_delta = busy_delta < 0 ? 0 : busy_delta;
+        waiting_delta = waiting_delta < 0 ? 0 : waiting_delta;
+
+        // Знаменатель не меньше 1: при нулевом интервале busy тоже 0
+        double total = static_cast<double>(busy_delta) + static_cast<double>(waiting_delta);
+        total = total < 1.0 ? 1.0 : total;
+        out[i] = static_cast<float>(100.0 * static_cast<double>(busy_delta) / total);
+    }
+}
+
+ssize_t readProcFile(const char* path, char* buf, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = read(fd, buf + total, size - total);
+        if (n < 0) {
+            close(fd);
+            return -1;
+        }
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+
+    close(fd);
+    return static_cast<ssize_t>(total);
+}
+
+bool formatProcPath(char* buf, size_t size, int pid, const char* file) {
+    static const char prefix[] = "/proc/";
+    size_t file_len = strlen(file);
+    if (size < sizeof(prefix) + 12 + file_len) return false;
+
+    char* p = buf;
+    memcpy(p, prefix, sizeof(prefix) - 1);
+    p += sizeof(prefix) - 1;
+    p = std::to_chars(p, buf + size, pid).ptr;
+    *p++ = '/';
+    memcpy(p, file, file_len + 1);
+    return true;
+}
+
+bool formatTaskPath(char* buf, size_t size, int pid, int tid, const char* file) {
+    static const char prefix[] = "/proc/";
+    static const char task[] = "/task/";
+    size_t file_len = strlen(file);
+    if (size < sizeof(prefix) + sizeof(task) + 24 + file_len) return false;
+
+    char* p = buf;
+    memcpy(p, prefix, sizeof(prefix) - 1);
+    p += sizeof(prefix) - 1;
+    p = std::to_chars(p, buf + size, pid).ptr;
+    memcpy(p, task, sizeof(task) - 1);
+    p += sizeof(task) - 1;
+    p = std::to_chars(p, buf + size, tid).ptr;
+    *p++ = '/';
+    memcpy(p, file, file_len + 1);
+    return true;
+}
+
+bool listProcPids(int proc_fd, std::vector<int>& pids) {
+    pids.clear();
+    if (proc_fd < 0 || lseek(proc_fd, 0, SEEK_SET) != 0) return false;
+
+    alignas(LinuxDirent64) char buf[32768];
+    while (true) {
+        long n = syscall(SYS_getdents64, proc_fd, buf, sizeof(buf));
+        if (n < 0) return false;
+        if (n == 0) break;
+
+        for (long offset = 0; offset < n;) {
+            const auto* entry = reinterpret_cast<const LinuxDirent64*>(buf + offset);
+            offset += entry->d_reclen;
+
+            // Каталоги процессов - только цифры, остальное (self, sys, ...) пропускаем
+            const char* name = entry->d_name;
+            if (entry->d_type != DT_DIR || *name < '1' || *name > '9') continue;
+
+            int pid = 0;
+            auto result = std::from_chars(name, name + strlen(name), pid);
+            if (result.ec == std::errc() && *result.ptr == '\0') {
+                pids.push_back(pid);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool readProcOwner(int proc_fd, int pid, int& uid) {
+    char pid_str[16];
+    *std::to_chars(pid_str, pid_str + sizeof(pid_str) - 1, pid).ptr = '\0';
+    struct stat dir_stat;
+    if (fstatat(proc_fd, pid_str, &dir_stat, 0) != 0) return false;
+    uid = static_cast<int>(dir_stat.st_uid);
+    return true;
+}
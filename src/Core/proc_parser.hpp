@@ -0,0 +1,159 @@
+#ifndef PROC_PARSER_HPP
+#define PROC_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <sys/types.h>
+
+// Fields of /proc/PID/stat, see proc(5). comm points into the parsed buffer.
+struct ProcStat {
+    std::string_view comm;
+    char state = '?';
+    int ppid = 0;
+    int64_t nice = 0;
+    int num_threads = 0;
+    uint64_t utime = 0;     // jiffies
+    uint64_t stime = 0;     // jiffies
+    uint64_t starttime = 0; // jiffies since boot
+    uint64_t vsize = 0;     // bytes
+    uint64_t rss = 0;       // pages
+};
+
+// Parses a /proc/PID/stat line in place, without allocating.
+// Returns false if the line is truncated or malformed.
+bool parseProcStat(const char* data, size_t len, ProcStat& out);
+
+// Per-CPU jiffy counters of the cpuN lines of /proc/stat as a structure of
+// arrays, one array per field, so per-core deltas are computed field by
+// field over contiguous memory.
+struct CpuTimes {
+    // user and nice include guest and guest_nice
+    enum Field { USER, NICE, SYSTEM, IDLE, IOWAIT, IRQ, SOFTIRQ, STEAL, GUEST, GUEST_NICE, FIELD_COUNT };
+
+    std::vector<int> ids; // N of each cpuN line; offline CPUs are not listed
+    std::vector<uint64_t> fields[FIELD_COUNT];
+
+    size_t size() const { return ids.size(); }
+};
+
+// Everything taken from /proc/stat, counters since boot
+struct KernelStat {
+    uint64_t cpu[CpuTimes::FIELD_COUNT] = {}; // aggregate "cpu" line, jiffies
+    CpuTimes cores;                           // cpuN lines
+    uint64_t interrupts = 0;                  // intr: total of all interrupts
+    uint64_t context_switches = 0;            // ctxt
+    uint64_t forks = 0;                       // processes: forks since boot
+    uint64_t procs_running = 0;
+    uint64_t procs_blocked = 0;
+};
+
+// Parses a /proc/stat buffer in a single pass; lines that are not needed
+// (the long per-IRQ intr tail, softirq, btime) are skipped with memchr.
+// The core arrays keep their capacity between ticks. Missing fields of
+// older kernels are zero.
+bool parseKernelStat(const char* data, size_t len, KernelStat& out);
+
+// Busy percent of every core between two samples of the same CPUs,
+// computed in a single pass over the field arrays.
+void computeCpuPercents(const CpuTimes& now, const CpuTimes& before, std::vector<float>& percents);
+
+// Fields of /proc/meminfo, kB unless noted
+struct MemInfo {
+    uint64_t total_kb = 0;
+    uint64_t free_kb = 0;
+    uint64_t available_kb = 0;
+    uint64_t buffers_kb = 0;
+    uint64_t cached_kb = 0;
+    uint64_t shmem_kb = 0;
+    uint64_t slab_kb = 0;
+    uint64_t dirty_kb = 0;
+    uint64_t writeback_kb = 0;
+    uint64_t swap_total_kb = 0;
+    uint64_t swap_free_kb = 0;
+    uint64_t hugepages_total = 0; // pages
+    uint64_t hugepages_free = 0;  // pages
+    uint64_t hugepage_size_kb = 0;
+};
+
+// Parses /proc/meminfo in one pass against a fixed key table, without
+// allocating. Keys missing on older kernels stay zero.
+bool parseMemInfo(const char* data, size_t len, MemInfo& out);
+
+// One /proc/pressure/<resource> file: percent of wall time in which some
+// (or all non-idle) tasks were stalled on the resource, averaged over 10,
+// 60 and 300 seconds, and the total stall time in microseconds
+struct PressureInfo {
+    double some[3] = {};
+    double full[3] = {};
+    uint64_t some_total = 0;
+    uint64_t full_total = 0;
+};
+
+bool parsePressure(const char* data, size_t len, PressureInfo& out);
+
+// Totals of /proc/PID/smaps_rollup, kB
+struct SmapsRollup {
+    uint64_t rss_kb = 0;
+    uint64_t pss_kb = 0;           // every shared page split between its users
+    uint64_t private_clean_kb = 0;
+    uint64_t private_dirty_kb = 0;
+    uint64_t private_hugetlb_kb = 0;
+    uint64_t swap_kb = 0;
+
+    // Unique set size: memory freed if the process exits
+    uint64_t ussKb() const { return private_clean_kb + private_dirty_kb + private_hugetlb_kb; }
+};
+
+// Parses smaps_rollup against a fixed key table, like parseMemInfo().
+// Returns false if none of the keys is present (kernel threads).
+bool parseSmapsRollup(const char* data, size_t len, SmapsRollup& out);
+
+// Cumulative counters of /proc/PID/io. rchar/wchar count every read() and
+// write() (sockets and pipes too); read_bytes/write_bytes only what reached
+// the block layer.
+struct ProcIo {
+    uint64_t rchar = 0;
+    uint64_t wchar = 0;
+    uint64_t syscr = 0;
+    uint64_t syscw = 0;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    uint64_t cancelled_write_bytes = 0; // dirty page cache truncated before writeback
+};
+
+bool parseProcIo(const char* data, size_t len, ProcIo& out);
+
+// Finds the cgroup v2 entry ("0::/path") of /proc/PID/cgroup. path points
+// into the buffer. Returns false if the process is not in a v2 hierarchy.
+bool parseProcCgroup(const char* data, size_t len, std::string_view& path);
+
+// Reads usage_usec, the CPU time of the whole cgroup, from its cpu.stat
+bool parseCgroupCpuStat(const char* data, size_t len, uint64_t& usage_usec);
+
+// Skips blanks and parses the next number at p. Returns the position after
+// the number, or nullptr if there is none.
+const char* parseNextNumber(const char* p, const char* end, uint64_t& value);
+const char* parseNextNumber(const char* p, const char* end, double& value);
+
+// Reads a whole procfs file into buf (open/read/close, no allocation).
+// Returns the number of bytes read, or -1 if the file could not be read.
+ssize_t readProcFile(const char* path, char* buf, size_t size);
+
+// Lists numeric entries of an open /proc directory with getdents64.
+// pids is cleared and refilled, keeping its capacity between ticks.
+bool listProcPids(int proc_fd, std::vector<int>& pids);
+
+// Effective UID of a process: the owner of its /proc/<pid> directory, so
+// /proc/PID/status does not have to be read. Fails once the process exited.
+bool readProcOwner(int proc_fd, int pid, int& uid);
+
+// Writes "/proc/<pid>/<file>" into buf. Returns false if it does not fit.
+bool formatProcPath(char* buf, size_t size, int pid, const char* file);
+
+// Writes "/proc/<pid>/task/<tid>/<file>". /proc/<tid>/stat would report the
+// whole thread group; per-thread counters are only under task/.
+bool formatTaskPath(char* buf, size_t size, int pid, int tid, const char* file);
+
+#endif // PROC_PARSER_HPP
@@ -0,0 +1,85 @@
+#include "process_collector.hpp"
+#include "system_info.hpp"
+#include "proc_parser.hpp"
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace {
+
+// Читает /proc/PID/stat через закэшированный дескриптор или открывает новый
+ssize_t readStatFile(ProcScanTask& task, char* buf, size_t size) {
+    if (task.fd >= 0) {
+        ssize_t len = preadFile(task.fd, buf, size);
+        if (len > 0) return len;
+        // ESRCH: процесс завершился, а PID мог достаться новому процессу
+        task.stale = true;
+    }
+
+    char path[80];
+    bool formatted = task.tgid != 0 ? formatTaskPath(path, sizeof(path), task.tgid, task.pid, "stat")
+                                    : formatProcPath(path, sizeof(path), task.pid, "stat");
+    if (!formatted) return -1;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    ssize_t len = preadFile(fd, buf, size);
+    if (task.keep) {
+        task.new_fd = fd;
+    } else {
+        close(fd); // Места в кэше нет - держать открытыми тысячи fd нельзя
+    }
+    return len;
+}
+
+// Обновляет один процесс из /proc; вызывается параллельно из потоков сборщика.
+// Имя, UID и признак kernel thread не меняются - берем их из кэша записи
+bool readProcessEntry(int proc_fd, uint64_t page_kb, ProcScanTask& task) {
+    char stat_buf[4096];
+    ProcessInfo& proc = *task.info;
+
+    // Читаем /proc/PID/stat в буфер на стеке и разбираем без аллокаций
+    ssize_t len = readStatFile(task, stat_buf, sizeof(stat_buf));
+    if (len <= 0) return false;
+
+    ProcStat proc_stat;
+    if (!parseProcStat(stat_buf, static_cast<size_t>(len), proc_stat)) {
+        return false; // Пропускаем процесс если данных недостаточно
+    }
+
+    // Новая запись, PID переиспользован или exec() сменил имя - заполняем заново
+    if (task.check_uid || proc.start_time != proc_stat.starttime || proc.name != proc_stat.comm) {
+        proc.pid = task.pid;
+        proc.name.assign(proc_stat.comm.data(), proc_stat.comm.size());
+
+        proc.is_kernel_thread = isKernelThread(task.pid, proc_stat.ppid);
+        task.check_uid = true;
+    }
+
+    proc.state.assign(1, proc_stat.state);
+    proc.memory_kb = proc_stat.rss * page_kb;
+    proc.cpu_time = proc_stat.utime + proc_stat.stime;
+    proc.start_time = proc_stat.starttime;
+    proc.threads = proc_stat.num_threads;
+    proc.ppid = proc_stat.ppid; // меняется, когда процесс усыновляет init или subreaper
+
+    // Владелец каталога /proc/PID - UID процесса, /proc/PID/status читать не нужно
+    if (task.check_uid && !readProcOwner(proc_fd, task.pid, proc.uid)) {
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+ProcfsCollector::ProcfsCollector(int proc_dir_fd) : proc_fd(proc_dir_fd) {
+    // Размер страницы зависит от ядра: на aarch64 бывает 16 и 64 KiB
+    long page_size = sysconf(_SC_PAGESIZE);
+    page_kb = page_size > 0 ? static_cast<uint64_t>(page_size) / 1024 : 4;
+}
+
+void ProcfsCollector::collect(size_t, ProcScanTask* tasks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        tasks[i].ok = readProcessEntry(proc_fd, page_kb, tasks[i]);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef PROCESS_COLLECTOR_HPP
+#define PROCESS_COLLECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+struct ProcScanTask;
+
+// Kernel threads: kthreadd (PID 2) and everything it started. Every
+// collector uses this, so show_kernel_threads hides the same rows whichever
+// one is active.
+inline bool isKernelThread(int pid, int ppid) {
+    return pid == 2 || ppid == 2;
+}
+
+// Per-process data source of SystemInfo::readProcesses. collect() refreshes
+// the ProcessInfo of each task in place and sets task.ok; the collector pool
+// calls it concurrently, every worker index on its own range of tasks.
+//
+// Collectors can be switched at run time over the same records, so fields
+// that identify a process have the same meaning in every collector:
+//   uid        - effective UID, the owner of /proc/PID (re-read when
+//                task.check_uid is set)
+//   start_time - clock ticks since boot, as starttime in /proc/PID/stat.
+//                A collector that derives it from another clock may be one
+//                tick off between reads; compare with sameStartTime().
+class ProcessCollector {
+public:
+    virtual ~ProcessCollector() = default;
+
+    virtual const char* name() const = 0;
+
+    // Tasks carry cached /proc/PID/stat descriptors (see ProcScanTask::fd)
+    virtual bool usesStatFds() const = 0;
+
+    // Called before a scan whenever the pool may have been resized
+    virtual void prepare(size_t workers) { (void)workers; }
+
+    virtual void collect(size_t worker, ProcScanTask* tasks, size_t count) = 0;
+};
+
+// Parses /proc/PID/stat (/proc/PID/task/TID/stat for thread tasks), the
+// owner of /proc/PID gives the UID. Works without privileges; this is the
+// default.
+class ProcfsCollector : public ProcessCollector {
+public:
+    explicit ProcfsCollector(int proc_dir_fd);
+
+    const char* name() const override { return "procfs"; }
+    bool usesStatFds() const override { return true; }
+    void collect(size_t worker, ProcScanTask* tasks, size_t count) override;
+
+private:
+    int proc_fd;      // /proc directory, owned by SystemInfo
+    uint64_t page_kb; // RSS in /proc/PID/stat is in pages: 4 KiB, 16 KiB or 64 KiB
+};
+
+#endif // PROCESS_COLLECTOR_HPP
@@ -0,0 +1,198 @@
+#include "process_filter.hpp"
+#include "system_info.hpp"
+#include <cstdlib>
+#include <fnmatch.h>
+
+void PatternMatcher::compile(const std::vector<std::string>& patterns) {
+    std::fill(std::begin(byte_class), std::end(byte_class), 0);
+    classes = 1;
+    next.clear();
+    accept.clear();
+    globs.clear();
+
+    std::vector<const std::string*> substrings;
+    for (const auto& pattern : patterns) {
+        if (pattern.empty()) continue;
+        if (pattern.find_first_of("*?[") != std::string::npos) {
+            globs.push_back(pattern);
+        } else {
+            substrings.push_back(&pattern);
+        }
+    }
+    if (substrings.empty()) return;
+
+    // Классы байтов: каждый байт из шаблонов - свой класс, остальные - класс 0.
+    // Таблица переходов получается states x classes, а не states x 256
+    for (const std::string* pattern : substrings) {
+        for (char ch : *pattern) {
+            uint8_t& cls = byte_class[static_cast<unsigned char>(ch)];
+            if (cls == 0) cls = static_cast<uint8_t>(classes++);
+        }
+    }
+
+    // Бор: -1 - перехода нет
+    next.assign(classes, -1);
+    accept.assign(1, false);
+    for (const std::string* pattern : substrings) {
+        int state = 0;
+        for (char ch : *pattern) {
+            int cls = byte_class[static_cast<unsigned char>(ch)];
+            if (next[state * classes + cls] < 0) {
+                next[state * classes + cls] = static_cast<int>(accept.size());
+                next.resize(next.size() + classes, -1);
+                accept.push_back(false);
+            }
+            state = next[state * classes + cls];
+        }
+        accept[state] = true;
+    }
+
+    // Суффиксные ссылки обходом в ширину; недостающие переходы заполняются
+    // переходами суффикса, и бор становится полным автоматом
+    std::vector<int> fail(accept.size(), 0);
+    std::vector<int> queue;
+    queue.reserve(accept.size());
+    for (int cls = 0; cls < classes; ++cls) {
+        int& to = next[cls];
+        if (to < 0) {
+            to = 0;
+        } else {
+            queue.push_back(to);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int state = queue[head];
+        for (int cls = 0; cls < classes; ++cls) {
+            int& to = next[state * classes + cls];
+            int via_fail = next[fail[state] * classes + cls];
+            if (to < 0) {
+                to = via_fail;
+            } else {
+                fail[to] = via_fail;
+                if (accept[via_fail]) accept[to] = true;
+                queue.push_back(to);
+            }
+        }
+    }
+}
+
+bool PatternMatcher::matches(std::string_view name) const {
+    if (!accept.empty()) {
+        int state = 0;
+        for (char ch : name) {
+            state = next[state * classes + byte_class[static_cast<unsigned char>(ch)]];
+            if (accept[state]) return true;
+        }
+    }
+    if (!globs.empty()) {
+        std::string text(name); // fnmatch нужна строка с нулем на конце
+        for (const auto& glob : globs) {
+            if (fnmatch(glob.c_str(), text.c_str(), 0) == 0) return true;
+        }
+    }
+    return false;
+}
+
+bool FilterExpression::matches(const ProcessInfo& proc, uint64_t memory_kb) const {
+    double value = 0.0;
+    switch (field) {
+        case Field::CPU: value = proc.cpu_percent; break;
+        case Field::MEMORY: value = static_cast<double>(memory_kb); break;
+        case Field::PID: value = proc.pid; break;
+        case Field::PPID: value = proc.ppid; break;
+        case Field::THREADS: value = proc.threads; break;
+        case Field::STATE:
+        case Field::USER: {
+            // Только равенство: для состояния и пользователя порядок не определен
+            bool equal = field == Field::STATE ? !proc.state.empty() && proc.state[0] == state
+                                               : uid >= 0 && proc.uid == uid;
+            return op == Op::NOT_EQUAL ? !equal : equal;
+        }
+    }
+
+    switch (op) {
+        case Op::LESS: return value < number;
+        case Op::LESS_EQUAL: return value <= number;
+        case Op::GREATER: return value > number;
+        case Op::GREATER_EQUAL: return value >= number;
+        case Op::EQUAL: return value == number;
+        case Op::NOT_EQUAL: return value != number;
+    }
+    return false;
+}
+
+bool parseFilterExpression(std::string_view text, FilterExpression& out) {
+    auto trim = [](std::string_view s) {
+        while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+        while (!s.empty() && s.back() == ' ') s.remove_suffix(1);
+        return s;
+    };
+
+    size_t op_pos = text.find_first_of("<>=!");
+    if (op_pos == std::string_view::npos) return false;
+    std::string_view name = trim(text.substr(0, op_pos));
+    std::string_view rest = text.substr(op_pos);
+
+    FilterExpression expr;
+    if (name == "cpu") expr.field = FilterExpression::Field::CPU;
+    else if (name == "mem") expr.field = FilterExpression::Field::MEMORY;
+    else if (name == "state") expr.field = FilterExpression::Field::STATE;
+    else if (name == "pid") expr.field = FilterExpression::Field::PID;
+    else if (name == "ppid") expr.field = FilterExpression::Field::PPID;
+    else if (name == "threads") expr.field = FilterExpression::Field::THREADS;
+    else if (name == "user") expr.field = FilterExpression::Field::USER;
+    else return false;
+
+    // Двухсимвольные операторы проверяются первыми; == равносильно =
+    static const struct { const char* text; FilterExpression::Op op; } ops[] = {
+        {"<=", FilterExpression::Op::LESS_EQUAL}, {">=", FilterExpression::Op::GREATER_EQUAL},
+        {"!=", FilterExpression::Op::NOT_EQUAL},  {"==", FilterExpression::Op::EQUAL},
+        {"<", FilterExpression::Op::LESS},        {">", FilterExpression::Op::GREATER},
+        {"=", FilterExpression::Op::EQUAL},
+    };
+    bool found = false;
+    for (const auto& op : ops) {
+        std::string_view op_text(op.text);
+        if (rest.substr(0, op_text.size()) == op_text) {
+            expr.op = op.op;
+            rest.remove_prefix(op_text.size());
+            found = true;
+            break;
+        }
+    }
+    if (!found) return false;
+
+    std::string_view value = trim(rest);
+    if (value.empty()) return false;
+
+    bool ordered = expr.op != FilterExpression::Op::EQUAL && expr.op != FilterExpression::Op::NOT_EQUAL;
+    if (expr.field == FilterExpression::Field::STATE) {
+        if (value.size() != 1 || ordered) return false;
+        expr.state = value[0];
+    } else if (expr.field == FilterExpression::Field::USER) {
+        if (ordered) return false;
+        expr.user.assign(value.data(), value.size());
+    } else {
+        std::string number(value);
+        char* end = nullptr;
+        expr.number = std::strtod(number.c_str(), &end);
+        if (end == number.c_str()) return false;
+        std::string_view suffix = trim(std::string_view(end));
+
+        if (expr.field == FilterExpression::Field::MEMORY) {
+            // Без суффикса - байты; хранится в kB, как memory_kb
+            double scale = 1.0 / 1024.0;
+            if (suffix == "K" || suffix == "k") scale = 1.0;
+            else if (suffix == "M" || suffix == "m") scale = 1024.0;
+            else if (suffix == "G" || suffix == "g") scale = 1024.0 * 1024.0;
+            else if (suffix == "T" || suffix == "t") scale = 1024.0 * 1024.0 * 1024.0;
+            else if (!suffix.empty()) return false;
+            expr.number *= scale;
+        } else if (!(suffix.empty() || (expr.field == FilterExpression::Field::CPU && suffix == "%"))) {
+            return false;
+        }
+    }
+
+    out = std::move(expr);
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef PROCESS_FILTER_HPP
+#define PROCESS_FILTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ProcessInfo;
+
+// hide_processes compiled once into a single matcher. Plain entries are
+// substrings of the name, matched all at once by an Aho-Corasick automaton
+// built as a dense DFA over the bytes that occur in the patterns, so a name
+// is scanned once whatever the number of patterns. Entries with * ? or [
+// are shell globs against the whole name (fnmatch).
+class PatternMatcher {
+public:
+    void compile(const std::vector<std::string>& patterns);
+
+    bool empty() const { return accept.empty() && globs.empty(); }
+
+    // True if any pattern matches name
+    bool matches(std::string_view name) const;
+
+private:
+    uint8_t byte_class[256] = {}; // 0 = a byte no pattern contains
+    int classes = 1;
+    std::vector<int> next;        // state * classes + class -> state
+    std::vector<bool> accept;     // a pattern ends here or at a suffix of it
+    std::vector<std::string> globs;
+};
+
+// One "field op value" condition, e.g. cpu>5, mem>=1G, state=D, user!=root.
+// Fields: cpu (percent), mem (bytes, K M G T suffixes), state, pid, ppid,
+// threads, user.
+struct FilterExpression {
+    enum class Field { CPU, MEMORY, STATE, PID, PPID, THREADS, USER };
+    enum class Op { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL };
+
+    Field field = Field::CPU;
+    Op op = Op::EQUAL;
+    double number = 0.0; // numeric fields; mem in kB
+    char state = '?';
+    std::string user;    // user: the name as given
+    int uid = -1;        // user: resolved by the caller, -1 = unknown user
+
+    // memory_kb is the memory the process is sorted by (RSS or PSS)
+    bool matches(const ProcessInfo& proc, uint64_t memory_kb) const;
+};
+
+// Parses an expression; false if text is not one (then it is a name filter)
+bool parseFilterExpression(std::string_view text, FilterExpression& out);
+
+#endif // PROCESS_FILTER_HPP
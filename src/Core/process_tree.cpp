@@ -0,0 +1,79 @@
+#include "process_tree.hpp"
+
+void ProcessTree::link() {
+    // PID -> индекс узла через плоский массив: растет до максимального PID и
+    // после прохода обнуляется только по занятым ячейкам, а не целиком
+    int max_pid = 0;
+    for (const Node& n : nodes) max_pid = std::max(max_pid, n.pid);
+    if (pid_slots.size() <= static_cast<size_t>(max_pid)) {
+        pid_slots.resize(static_cast<size_t>(max_pid) + 1, 0);
+    }
+
+    int count = static_cast<int>(nodes.size());
+    for (int i = 0; i < count; ++i) {
+        pid_slots[nodes[i].pid] = i + 1;
+    }
+    for (int i = 0; i < count; ++i) {
+        Node& n = nodes[i];
+        int slot = n.ppid > 0 && n.ppid <= max_pid ? pid_slots[n.ppid] : 0;
+        n.parent = slot > 0 && slot - 1 != i ? slot - 1 : -1;
+    }
+    for (const Node& n : nodes) {
+        pid_slots[n.pid] = 0;
+    }
+
+    sorted.resize(nodes.size());
+    for (int i = 0; i < count; ++i) sorted[i] = i;
+    linkChildren();
+    walk();
+
+    // В обратном прямом порядке каждый потомок встречается раньше предка
+    for (size_t i = preorder.size(); i-- > 0;) {
+        const Node& n = nodes[preorder[i]];
+        if (n.parent < 0) continue;
+        Node& parent = nodes[n.parent];
+        parent.cpu_percent += n.cpu_percent;
+        parent.memory_kb += n.memory_kb;
+        parent.processes += n.processes;
+    }
+}
+
+void ProcessTree::linkChildren() {
+    // Вставка в голову списка, поэтому sorted обходится с конца
+    for (Node& n : nodes) {
+        n.first_child = -1;
+        n.next_sibling = -1;
+    }
+    first_root = -1;
+    for (size_t k = sorted.size(); k-- > 0;) {
+        int i = sorted[k];
+        int& head = nodes[i].parent >= 0 ? nodes[nodes[i].parent].first_child : first_root;
+        nodes[i].next_sibling = head;
+        head = i;
+    }
+}
+
+void ProcessTree::walk() {
+    // Обход в глубину по ссылкам parent/first_child/next_sibling, без стека
+    preorder.clear();
+    for (int root = first_root; root >= 0; root = nodes[root].next_sibling) {
+        int i = root;
+        nodes[i].depth = 0;
+        while (true) {
+            preorder.push_back(i);
+            if (nodes[i].first_child >= 0) {
+                int child = nodes[i].first_child;
+                nodes[child].depth = nodes[i].depth + 1;
+                i = child;
+                continue;
+            }
+            while (i != root && nodes[i].next_sibling < 0) {
+                i = nodes[i].parent;
+            }
+            if (i == root) break;
+            int sibling = nodes[i].next_sibling;
+            nodes[sibling].depth = nodes[i].depth;
+            i = sibling;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PROCESS_TREE_HPP
+#define PROCESS_TREE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Parent/child hierarchy of a set of processes, rebuilt every tick in linear
+// time. Parents are resolved through a flat array indexed by PID instead of
+// a map, children are kept as first-child/next-sibling lists, and subtree
+// totals are summed bottom-up over the preorder. Node i is the i-th add().
+class ProcessTree {
+public:
+    struct Node {
+        int pid;
+        int ppid;
+        int parent;       // node index, -1 = root (the parent is not in the set)
+        int first_child;  // -1 = leaf
+        int next_sibling; // -1 = last child of its parent
+        int depth;        // 0 for roots
+
+        // Subtree totals, the process itself included
+        double cpu_percent;
+        uint64_t memory_kb;
+        int processes;
+    };
+
+    void clear() { nodes.clear(); }
+
+    void add(int pid, int ppid, double cpu_percent, uint64_t memory_kb) {
+        nodes.push_back({pid, ppid, -1, -1, -1, 0, cpu_percent, memory_kb, 1});
+    }
+
+    // Resolves parents and sums subtree totals, O(n)
+    void link();
+
+    // Orders every sibling list (and the roots) by less(i, j) on node indices
+    // with one sort of all nodes, then rebuilds the preorder
+    template <typename Less>
+    void sortSiblings(Less less) {
+        sorted.resize(nodes.size());
+        for (size_t i = 0; i < sorted.size(); ++i) sorted[i] = static_cast<int>(i);
+        std::sort(sorted.begin(), sorted.end(), less);
+        linkChildren();
+        walk();
+    }
+
+    const Node& node(int i) const { return nodes[i]; }
+
+    // Node indices in preorder: every node is followed by its subtree
+    const std::vector<int>& rows() const { return preorder; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<int> pid_slots; // PID -> node index + 1, 0 = absent; all zero between builds
+    std::vector<int> sorted;    // sibling order, linked back to front
+    std::vector<int> preorder;
+    int first_root = -1;
+
+    void linkChildren();
+    void walk();
+};
+
+#endif // PROCESS_TREE_HPP
@@ -0,0 +1,465 @@
+#include "recording.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char magic[8] = {'M', 'T', 'O', 'P', 'R', 'E', 'C', '1'};
+constexpr uint32_t format_version = 1;
+constexpr size_t header_size = 16;
+constexpr size_t frame_header_size = 5;
+
+enum FrameType : uint8_t {
+    KEYFRAME = 1,
+    DELTA = 2
+};
+
+enum RowFlags : uint8_t {
+    ROW_KERNEL_THREAD = 1,
+    ROW_MEMORY_DELTA = 2
+};
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void putZigzag(std::string& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint64_t toFixed(double value, double scale) {
+    return value > 0 ? static_cast<uint64_t>(std::llround(value * scale)) : 0;
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+           static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+// Чтение varint с проверкой границ; при ошибке reader переходит в состояние failed
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool failed = false;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) break;
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        failed = true;
+        return 0;
+    }
+
+    int64_t zigzag() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    uint8_t byte() {
+        if (p >= end) {
+            failed = true;
+            return 0;
+        }
+        return *p++;
+    }
+
+    std::string string(size_t len) {
+        if (static_cast<size_t>(end - p) < len) {
+            failed = true;
+            return std::string();
+        }
+        std::string text(reinterpret_cast<const char*>(p), len);
+        p += len;
+        return text;
+    }
+};
+
+} // namespace
+
+SessionRecorder::SessionRecorder() : fd(-1), end_offset(0), frames_since_keyframe(0), prev_system{0, 0, 0} {
+}
+
+SessionRecorder::~SessionRecorder() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool SessionRecorder::open(const std::string& path, std::string& error) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        error = strerror(errno);
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        std::string header(magic, sizeof(magic));
+        putU32(header, format_version);
+        putU32(header, 0);
+        if (write(fd, header.data(), header.size()) != static_cast<ssize_t>(header.size())) {
+            error = strerror(errno);
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        end_offset = static_cast<off_t>(header_size);
+    } else {
+        // Дописываем только в запись того же формата, иначе кадры окажутся после мусора
+        uint8_t header[header_size];
+        if (pread(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            memcmp(header, magic, sizeof(magic)) != 0 || readU32(header + 8) != format_version) {
+            error = "exists and is not an mtop recording of this version";
+            close(fd);
+            fd = -1;
+            return false;
+        }
+
+        // Проходим по заголовкам кадров, как SessionPlayer::buildIndex(); недописанный
+        // хвост отрезаем, иначе воспроизведение остановится на нем
+        off_t offset = static_cast<off_t>(header_size);
+        uint8_t frame_header[frame_header_size];
+        while (pread(fd, frame_header, sizeof(frame_header), offset) == static_cast<ssize_t>(sizeof(frame_header))) {
+            off_t length = static_cast<off_t>(readU32(frame_header));
+            uint8_t type = frame_header[4];
+            off_t next = offset + static_cast<off_t>(frame_header_size) + length;
+            if ((type != KEYFRAME && type != DELTA) || next > st.st_size) break;
+            offset = next;
+        }
+        if (offset < st.st_size && ftruncate(fd, offset) != 0) {
+            error = strerror(errno);
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        end_offset = offset;
+    }
+
+    // При дозаписи в существующий файл начинаем с ключевого кадра
+    frames_since_keyframe = keyframe_interval;
+    return true;
+}
+
+uint32_t SessionRecorder::intern(const std::string& text, std::string& defs, uint32_t& new_count) {
+    auto it = strings.find(text);
+    if (it != strings.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.emplace(text, id);
+    putVarint(defs, text.size());
+    defs += text;
+    new_count++;
+    return id;
+}
+
+bool SessionRecorder::append(const SystemStats& stats, double timestamp) {
+    if (fd < 0) return false;
+
+    bool keyframe = frames_since_keyframe >= keyframe_interval;
+    if (keyframe) {
+        strings.clear();
+        prev_memory.clear();
+        frames_since_keyframe = 0;
+    }
+    frames_since_keyframe++;
+
+    // Строки для строк таблицы собираются отдельно: определения идут перед строками
+    std::string defs;
+    std::string rows;
+    uint32_t new_strings = 0;
+    int prev_pid = 0;
+
+    next_memory.clear();
+    putVarint(rows, stats.processes.size());
+    for (const auto& proc : stats.processes) {
+        putZigzag(rows, static_cast<int64_t>(proc.pid) - prev_pid);
+        prev_pid = proc.pid;
+
+        putVarint(rows, intern(proc.name, defs, new_strings));
+        putVarint(rows, intern(proc.user, defs, new_strings));
+        rows += proc.state.empty() ? '?' : proc.state[0];
+        putVarint(rows, static_cast<uint32_t>(proc.uid));
+
+        auto prev = prev_memory.find(proc.pid);
+        uint8_t flags = proc.is_kernel_thread ? ROW_KERNEL_THREAD : 0;
+        if (prev != prev_memory.end()) flags |= ROW_MEMORY_DELTA;
+        rows += static_cast<char>(flags);
+
+        putVarint(rows, toFixed(proc.cpu_percent, 10.0));
+        if (prev != prev_memory.end()) {
+            putZigzag(rows, static_cast<int64_t>(proc.memory_kb - prev->second));
+        } else {
+            putVarint(rows, proc.memory_kb);
+        }
+        next_memory[proc.pid] = proc.memory_kb;
+    }
+    prev_memory.swap(next_memory);
+
+    frame.clear();
+    putU32(frame, 0); // длина, заполняется ниже
+    frame += static_cast<char>(keyframe ? KEYFRAME : DELTA);
+
+    putVarint(frame, toFixed(timestamp, 1000.0));
+    putVarint(frame, toFixed(stats.cpu_percent, 10.0));
+
+    uint64_t system[3] = {stats.total_memory_kb, stats.used_memory_kb, stats.free_memory_kb};
+    for (int i = 0; i < 3; ++i) {
+        if (keyframe) {
+            putVarint(frame, system[i]);
+        } else {
+            putZigzag(frame, static_cast<int64_t>(system[i] - prev_system[i]));
+        }
+        prev_system[i] = system[i];
+    }
+
+    for (double load : stats.load_avg) {
+        putVarint(frame, toFixed(load, 100.0));
+    }
+    putVarint(frame, static_cast<uint64_t>(std::max(0, stats.process_count)));
+
+    putVarint(frame, new_strings);
+    frame += defs;
+    frame += rows;
+
+    uint32_t payload = static_cast<uint32_t>(frame.size() - frame_header_size);
+    for (int i = 0; i < 4; ++i) {
+        frame[i] = static_cast<char>((payload >> (8 * i)) & 0xFF);
+    }
+
+    // Кадр пишется одним write() с O_APPEND - при падении теряется максимум хвост
+    size_t written = 0;
+    while (written < frame.size()) {
+        ssize_t n = write(fd, frame.data() + written, frame.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fail(strerror(errno));
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    end_offset += static_cast<off_t>(frame.size());
+    return true;
+}
+
+void SessionRecorder::fail(const char* reason) {
+    // Частично записанный кадр отрезаем: кадры, дописанные после него, были бы
+    // недостижимы при воспроизведении. Дальше не пишем - диск полон или сбоит
+    write_error = reason;
+    if (ftruncate(fd, end_offset) != 0) {
+        write_error += " (a partial frame may remain at the end)";
+    }
+    close(fd);
+    fd = -1;
+}
+
+SessionPlayer::SessionPlayer() : data(nullptr), size(0), current(0), prev_system{0, 0, 0} {
+}
+
+SessionPlayer::~SessionPlayer() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+}
+
+bool SessionPlayer::open(const std::string& path, std::string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(header_size)) {
+        close(fd);
+        error = "not an mtop recording";
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        error = strerror(errno);
+        return false;
+    }
+
+    data = static_cast<const uint8_t*>(mapped);
+    size = static_cast<size_t>(st.st_size);
+
+    if (memcmp(data, magic, sizeof(magic)) != 0 || readU32(data + 8) != format_version) {
+        error = "not an mtop recording or unsupported version";
+        return false;
+    }
+
+    buildIndex();
+    if (keyframes.empty()) {
+        error = "recording contains no frames";
+        return false;
+    }
+
+    seek(startTime());
+    return true;
+}
+
+void SessionPlayer::buildIndex() {
+    // Проходим только по заголовкам кадров; недописанный хвост (падение) отбрасываем
+    size_t offset = header_size;
+    while (offset + frame_header_size <= size) {
+        size_t length = readU32(data + offset);
+        uint8_t type = data[offset + 4];
+        size_t payload = offset + frame_header_size;
+        if (length > size - payload || (type != KEYFRAME && type != DELTA)) break;
+
+        Reader reader{data + payload, data + payload + length};
+        double timestamp = static_cast<double>(reader.varint()) / 1000.0;
+        if (reader.failed) break;
+
+        // Дельта-кадры до первого ключевого декодировать не от чего
+        if (type == KEYFRAME || !keyframes.empty()) {
+            if (type == KEYFRAME) keyframes.push_back(frames.size());
+            frames.push_back(FrameIndex{payload, length, timestamp, type == KEYFRAME});
+        }
+        offset = payload + length;
+    }
+}
+
+double SessionPlayer::startTime() const {
+    return frames.empty() ? 0.0 : frames.front().timestamp;
+}
+
+double SessionPlayer::endTime() const {
+    return frames.empty() ? 0.0 : frames.back().timestamp;
+}
+
+void SessionPlayer::seek(double timestamp) {
+    if (frames.empty()) return;
+
+    // Последний ключевой кадр не позже timestamp - O(log n)
+    auto key = std::upper_bound(keyframes.begin(), keyframes.end(), timestamp,
+                                [this](double t, size_t index) { return t < frames[index].timestamp; });
+    size_t start = key == keyframes.begin() ? keyframes.front() : *(key - 1);
+
+    // Декодируем вперед до нужного кадра, чтобы восстановить строки и базу дельт
+    SystemStats scratch;
+    current = start;
+    while (current + 1 < frames.size() && frames[current + 1].timestamp <= timestamp) {
+        if (!decode(frames[current], scratch)) break;
+        current++;
+    }
+}
+
+bool SessionPlayer::peekTimestamp(double& timestamp) const {
+    if (current >= frames.size()) return false;
+    timestamp = frames[current].timestamp;
+    return true;
+}
+
+bool SessionPlayer::next(SystemStats& stats, double& timestamp) {
+    if (current >= frames.size()) return false;
+
+    const FrameIndex& frame = frames[current];
+    timestamp = frame.timestamp;
+    if (!decode(frame, stats)) {
+        current = frames.size();
+        return false;
+    }
+    current++;
+    return true;
+}
+
+bool SessionPlayer::decode(const FrameIndex& frame, SystemStats& stats) {
+    Reader reader{data + frame.offset, data + frame.offset + frame.length};
+
+    if (frame.keyframe) {
+        strings.clear();
+        prev_memory.clear();
+    }
+
+    reader.varint(); // timestamp уже в индексе
+    stats.cpu_percent = static_cast<double>(reader.varint()) / 10.0;
+
+    uint64_t system[3];
+    for (int i = 0; i < 3; ++i) {
+        system[i] = frame.keyframe ? reader.varint()
+                                   : prev_system[i] + static_cast<uint64_t>(reader.zigzag());
+        prev_system[i] = system[i];
+    }
+    stats.total_memory_kb = system[0];
+    stats.used_memory_kb = system[1];
+    stats.free_memory_kb = system[2];
+
+    for (double& load : stats.load_avg) {
+        load = static_cast<double>(reader.varint()) / 100.0;
+    }
+    stats.process_count = static_cast<int>(reader.varint());
+
+    uint64_t new_strings = reader.varint();
+    for (uint64_t i = 0; i < new_strings && !reader.failed; ++i) {
+        strings.push_back(reader.string(reader.varint()));
+    }
+
+    uint64_t rows = reader.varint();
+    if (reader.failed || rows > frame.length) return false;
+
+    stats.processes.clear();
+    next_memory.clear();
+    int pid = 0;
+
+    for (uint64_t i = 0; i < rows && !reader.failed; ++i) {
+        ProcessInfo proc{};
+        pid += static_cast<int>(reader.zigzag());
+        proc.pid = pid;
+
+        uint64_t name_id = reader.varint();
+        uint64_t user_id = reader.varint();
+        if (name_id >= strings.size() || user_id >= strings.size()) return false;
+        proc.name = strings[name_id];
+        proc.user = strings[user_id];
+        proc.state.assign(1, static_cast<char>(reader.byte()));
+        proc.uid = static_cast<int>(reader.varint());
+
+        uint8_t flags = reader.byte();
+        proc.is_kernel_thread = flags & ROW_KERNEL_THREAD;
+        proc.cpu_percent = static_cast<double>(reader.varint()) / 10.0;
+
+        if (flags & ROW_MEMORY_DELTA) {
+            proc.memory_kb = prev_memory[pid] + static_cast<uint64_t>(reader.zigzag());
+        } else {
+            proc.memory_kb = reader.varint();
+        }
+        next_memory[pid] = proc.memory_kb;
+
+        stats.processes.push_back(std::move(proc));
+    }
+    prev_memory.swap(next_memory);
+
+    return !reader.failed;
+}
@@ -0,0 +1,108 @@
+#ifndef RECORDING_HPP
+#define RECORDING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+#include "system_info.hpp"
+
+// Session recording format (all integers LEB128 varints unless noted):
+//
+//   header:  "MTOPREC1" u32 version u32 reserved
+//   frame:   u32 payload length, u8 type (1 = keyframe, 2 = delta), payload
+//   payload: timestamp (ms since epoch), system stats, new strings, rows
+//
+// Names and users are interned; a keyframe resets the string table and
+// stores absolute values, so decoding can start at any keyframe. Delta
+// frames store memory as zigzag deltas against the previous frame and
+// PIDs as zigzag deltas against the previous row.
+
+class SessionRecorder {
+public:
+    SessionRecorder();
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Opens (or appends to) a recording; returns false with error set. An
+    // existing file must start with a valid header; an incomplete last
+    // frame (crash mid-write) is cut off so new frames stay reachable.
+    bool open(const std::string& path, std::string& error);
+
+    // Writes one frame. On a failed write (ENOSPC, EIO) the partial frame
+    // is truncated away, the file is closed and every later call returns
+    // false; error() tells why.
+    bool append(const SystemStats& stats, double timestamp);
+
+    const std::string& error() const { return write_error; }
+
+private:
+    static constexpr int keyframe_interval = 60;
+
+    int fd;
+    off_t end_offset; // end of the last complete frame
+    std::string write_error;
+    int frames_since_keyframe;
+    std::string frame;
+    std::unordered_map<std::string, uint32_t> strings;
+    std::unordered_map<int, uint64_t> prev_memory;
+    std::unordered_map<int, uint64_t> next_memory;
+    uint64_t prev_system[3];
+
+    uint32_t intern(const std::string& text, std::string& defs, uint32_t& new_count);
+    void fail(const char* reason);
+};
+
+class SessionPlayer {
+public:
+    SessionPlayer();
+    ~SessionPlayer();
+
+    SessionPlayer(const SessionPlayer&) = delete;
+    SessionPlayer& operator=(const SessionPlayer&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+
+    size_t frameCount() const { return frames.size(); }
+    size_t position() const { return current; }
+    double startTime() const;
+    double endTime() const;
+
+    // Positions on the last frame recorded at or before timestamp.
+    // Binary search over the keyframe index, then decodes forward.
+    void seek(double timestamp);
+
+    // Timestamp of the frame next() would return; false at the end
+    bool peekTimestamp(double& timestamp) const;
+
+    // Decodes the current frame and advances
+    bool next(SystemStats& stats, double& timestamp);
+
+private:
+    struct FrameIndex {
+        size_t offset;   // payload start
+        size_t length;
+        double timestamp;
+        bool keyframe;
+    };
+
+    const uint8_t* data;
+    size_t size;
+    std::vector<FrameIndex> frames;
+    std::vector<size_t> keyframes; // indices into frames
+    size_t current;
+
+    std::vector<std::string> strings;
+    std::unordered_map<int, uint64_t> prev_memory;
+    std::unordered_map<int, uint64_t> next_memory;
+    uint64_t prev_system[3];
+
+    void buildIndex();
+    bool decode(const FrameIndex& frame, SystemStats& stats);
+};
+
+#endif // RECORDING_HPP
@@ -0,0 +1,119 @@
+#include "sampler.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+std::chrono::steady_clock::duration toDuration(double seconds) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+}
+
+double currentTimestamp() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+Sampler::Sampler(SystemInfo& sys, const MtopConfig& config, SessionRecorder* rec)
+    : system(sys), recorder(rec), current(sys.getStats()), pending_config(config),
+      config_changed(false), stopping(false), recording_error_taken(false),
+      interval(toDuration(config.update_interval)) {
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    worker = std::thread(&Sampler::run, this);
+}
+
+Sampler::~Sampler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_one();
+    worker.join();
+
+    if (event_fd >= 0) {
+        close(event_fd);
+    }
+}
+
+std::shared_ptr<const SystemStats> Sampler::latest() {
+    uint64_t count;
+    while (read(event_fd, &count, sizeof(count)) > 0) {
+    }
+    return std::atomic_load(&current);
+}
+
+void Sampler::updateConfig(const MtopConfig& new_config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_config = new_config;
+        config_changed = true;
+    }
+    cv.notify_one();
+}
+
+bool Sampler::takeRecordingError(std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (recording_error.empty() || recording_error_taken) return false;
+    recording_error_taken = true;
+    error = recording_error;
+    return true;
+}
+
+void Sampler::publish() {
+    std::atomic_store(&current, system.getStats());
+
+    uint64_t one = 1;
+    ssize_t written = write(event_fd, &one, sizeof(one));
+    (void)written; // счетчик eventfd переполниться не может - UI читает его каждый раз
+}
+
+void Sampler::run() {
+    // Первый замер сделан в конструкторе SystemInfo: первый тик не позже чем через
+    // секунду, дальше - строго по монотонному дедлайну, без накопления задержек
+    Clock::time_point deadline = Clock::now() + std::min(interval, toDuration(1.0));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        cv.wait_until(lock, deadline, [this] { return stopping || config_changed; });
+        if (stopping) break;
+
+        if (config_changed) {
+            MtopConfig config = pending_config;
+            config_changed = false;
+            interval = toDuration(config.update_interval);
+            lock.unlock();
+
+            // Сортировка и фильтры пересчитываются по последнему скану сразу
+            system.updateConfig(config);
+            system.rebuildView();
+            publish();
+
+            lock.lock();
+            continue;
+        }
+
+        lock.unlock();
+        system.updateStats();
+        bool recording_failed = recorder && !recorder->append(*system.getStats(), currentTimestamp());
+        lock.lock();
+
+        // Запись остановлена; сообщение забирает UI до публикации снимка
+        if (recording_failed) {
+            recording_error = recorder->error();
+            recorder = nullptr;
+        }
+        lock.unlock();
+        publish();
+        lock.lock();
+
+        // Тики, пропущенные из-за медленного скана, не догоняем
+        Clock::time_point now = Clock::now();
+        deadline += interval;
+        if (deadline < now) {
+            deadline = now + interval;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SAMPLER_HPP
+#define SAMPLER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "parser.hpp"
+#include "recording.hpp"
+#include "system_info.hpp"
+
+// Runs SystemInfo on its own thread so a slow /proc scan never stalls the
+// UI. Each sample is published as an immutable snapshot with an atomic
+// shared_ptr store; readers load the latest one without copying and keep
+// it alive for as long as they render it. notifyFd() (an eventfd) becomes
+// readable whenever a new snapshot is published.
+class Sampler {
+public:
+    // system must not be used by other threads while the sampler runs;
+    // recorder (optional) is written from the sampler thread
+    Sampler(SystemInfo& system, const MtopConfig& config, SessionRecorder* recorder);
+    ~Sampler();
+
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    int notifyFd() const { return event_fd; }
+
+    // Clears notifyFd() and returns the latest snapshot
+    std::shared_ptr<const SystemStats> latest();
+
+    // Applied on the sampler thread; view changes are re-published from the
+    // cached scan at once, the interval takes effect from the next tick
+    void updateConfig(const MtopConfig& new_config);
+
+    // Why recording stopped, returned once; false while it works or is off
+    bool takeRecordingError(std::string& error);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SystemInfo& system;
+    SessionRecorder* recorder;
+    int event_fd;
+    std::shared_ptr<const SystemStats> current;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    MtopConfig pending_config;
+    bool config_changed;
+    bool stopping;
+    std::string recording_error; // set once when recorder->append() fails
+    bool recording_error_taken;
+    Clock::duration interval;
+
+    std::thread worker;
+
+    void run();
+    void publish();
+};
+
+#endif // SAMPLER_HPP
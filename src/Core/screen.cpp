@@ -0,0 +1,239 @@
+#include "screen.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+// Короткие промежутки без изменений дешевле перерисовать, чем двигать курсор
+constexpr int max_gap = 6;
+
+void appendNumber(std::string& out, int value) {
+    char buf[16];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+} // namespace
+
+bool Screen::Cell::operator==(const Cell& other) const {
+    return len == other.len && style == other.style && memcmp(glyph, other.glyph, len) == 0;
+}
+
+Screen::Cell Screen::blankCell() {
+    Cell cell;
+    cell.glyph[0] = ' ';
+    cell.len = 1;
+    cell.style = 0;
+    return cell;
+}
+
+Screen::Screen()
+    : width(0), height(0), cur_row(0), cur_col(0), cur_style(0), full_redraw(true) {
+    styles.emplace_back();
+    querySize();
+
+    // Скрываем курсор
+    out = "\033[?25l";
+    flush();
+}
+
+Screen::~Screen() {
+    // Курсор под последним кадром, показываем его и сбрасываем цвета
+    out = "\033[0m\033[";
+    appendNumber(out, height);
+    out += ";1H\n\033[?25h";
+    flush();
+}
+
+void Screen::querySize() {
+    struct winsize ws;
+    int new_width = 80;
+    int new_height = 24;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        new_width = ws.ws_col;
+        new_height = ws.ws_row;
+    }
+
+    if (new_width != width || new_height != height) {
+        width = new_width;
+        height = new_height;
+        front.assign(static_cast<size_t>(width) * height, blankCell());
+        full_redraw = true;
+    }
+}
+
+void Screen::beginFrame() {
+    querySize();
+    back.assign(static_cast<size_t>(width) * height, blankCell());
+    cur_row = 0;
+    cur_col = 0;
+    cur_style = 0;
+}
+
+void Screen::setStyle(std::string_view sgr) {
+    for (size_t i = 0; i < styles.size(); ++i) {
+        if (styles[i] == sgr) {
+            cur_style = static_cast<uint16_t>(i);
+            return;
+        }
+    }
+    styles.emplace_back(sgr);
+    cur_style = static_cast<uint16_t>(styles.size() - 1);
+}
+
+void Screen::resetStyle() {
+    cur_style = 0;
+}
+
+void Screen::put(const char* glyph, uint8_t len) {
+    if (cur_row >= height || cur_col >= width) {
+        cur_col++;
+        return;
+    }
+
+    Cell& cell = back[static_cast<size_t>(cur_row) * width + cur_col];
+    memcpy(cell.glyph, glyph, len);
+    cell.len = len;
+    cell.style = cur_style;
+    cur_col++;
+}
+
+void Screen::print(std::string_view text) {
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        if (c == '\n') {
+            newline();
+            i++;
+            continue;
+        }
+
+        // Длина UTF-8 последовательности по первому байту
+        size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        bool valid = len > 0 && i + len <= text.size();
+        for (size_t k = 1; valid && k < len; ++k) {
+            valid = (static_cast<unsigned char>(text[i + k]) & 0xC0) == 0x80;
+        }
+
+        // Управляющие символы и битый UTF-8 (имена процессов - произвольные байты)
+        // не должны попасть в терминал как есть
+        if (!valid || c < 0x20 || c == 0x7F) {
+            put("?", 1);
+            i += valid ? len : 1;
+            continue;
+        }
+
+        put(text.data() + i, static_cast<uint8_t>(len));
+        i += len;
+    }
+}
+
+void Screen::printPadded(std::string_view text, int field_width, bool align_right) {
+    // Ширина считается в символах, а не в байтах
+    int glyphs = 0;
+    for (char ch : text) {
+        if ((static_cast<unsigned char>(ch) & 0xC0) != 0x80) glyphs++;
+    }
+
+    int padding = std::max(0, field_width - glyphs);
+    if (align_right) {
+        for (int i = 0; i < padding; ++i) put(" ", 1);
+        print(text);
+    } else {
+        print(text);
+        for (int i = 0; i < padding; ++i) put(" ", 1);
+    }
+}
+
+void Screen::newline() {
+    cur_row++;
+    cur_col = 0;
+}
+
+void Screen::moveTo(int row, int col) {
+    cur_row = row;
+    cur_col = col;
+}
+
+void Screen::emitStyle(uint16_t style) {
+    out += "\033[0m";
+    out += styles[style];
+}
+
+void Screen::present() {
+    out.clear();
+    if (back.size() != front.size()) return;
+
+    if (full_redraw) {
+        out += "\033[0m\033[2J";
+        std::fill(front.begin(), front.end(), blankCell());
+        full_redraw = false;
+    }
+
+    uint16_t emitted_style = 0;
+    bool style_known = false;
+
+    for (int row = 0; row < height; ++row) {
+        const Cell* old_row = &front[static_cast<size_t>(row) * width];
+        const Cell* new_row = &back[static_cast<size_t>(row) * width];
+
+        int col = 0;
+        while (col < width) {
+            if (old_row[col] == new_row[col]) {
+                col++;
+                continue;
+            }
+
+            // Начало измененного участка: позиционируем курсор (1-based)
+            out += "\033[";
+            appendNumber(out, row + 1);
+            out += ';';
+            appendNumber(out, col + 1);
+            out += 'H';
+
+            int gap = 0;
+            int end = col;
+            while (end < width && gap <= max_gap) {
+                gap = (old_row[end] == new_row[end]) ? gap + 1 : 0;
+                end++;
+            }
+            end -= gap;
+
+            for (; col < end; ++col) {
+                const Cell& cell = new_row[col];
+                if (!style_known || cell.style != emitted_style) {
+                    emitStyle(cell.style);
+                    emitted_style = cell.style;
+                    style_known = true;
+                }
+                out.append(cell.glyph, cell.len);
+            }
+        }
+    }
+
+    if (!out.empty()) {
+        if (emitted_style != 0) out += "\033[0m";
+        flush();
+    }
+
+    front.swap(back);
+}
+
+void Screen::flush() {
+    // Весь кадр уходит одним write(), дописываем только при частичной записи
+    size_t written = 0;
+    while (written < out.size()) {
+        ssize_t n = write(STDOUT_FILENO, out.data() + written, out.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    out.clear();
+}
@@ -0,0 +1,73 @@
+#ifndef SCREEN_HPP
+#define SCREEN_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Double-buffered terminal frame. A frame is composed into a cell grid,
+// diffed against the previous one, and only changed runs are emitted with
+// cursor-positioning sequences in a single write().
+class Screen {
+public:
+    Screen();
+    ~Screen();
+
+    Screen(const Screen&) = delete;
+    Screen& operator=(const Screen&) = delete;
+
+    int rows() const { return height; }
+    int cols() const { return width; }
+
+    // Starts composing a new frame; picks up terminal resizes
+    void beginFrame();
+
+    // SGR sequence for the following text, e.g. "\033[1;34m". Each style is
+    // absolute: it is applied on top of a reset, not on top of the previous one.
+    void setStyle(std::string_view sgr);
+    void resetStyle();
+
+    // Writes UTF-8 text at the cursor; clipped at the right edge
+    void print(std::string_view text);
+    void printPadded(std::string_view text, int field_width, bool align_right = false);
+    void newline();
+    void moveTo(int row, int col);
+    int cursorRow() const { return cur_row; }
+
+    // Diffs against the previous frame and writes the changes to stdout
+    void present();
+
+    // Forces the next present() to repaint everything
+    void invalidate() { full_redraw = true; }
+
+private:
+    struct Cell {
+        char glyph[4];
+        uint8_t len;
+        uint16_t style;
+
+        bool operator==(const Cell& other) const;
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    int width;
+    int height;
+    int cur_row;
+    int cur_col;
+    uint16_t cur_style;
+    bool full_redraw;
+
+    std::vector<Cell> front;
+    std::vector<Cell> back;
+    std::vector<std::string> styles; // interned SGR sequences, 0 = default
+    std::string out;
+
+    static Cell blankCell();
+    void querySize();
+    void put(const char* glyph, uint8_t len);
+    void emitStyle(uint16_t style);
+    void flush();
+};
+
+#endif // SCREEN_HPP
@@ -0,0 +1,364 @@
+#include "serializer.hpp"
+#include <charconv>
+
+StatsSerializer::StatsSerializer(MtopConfig::OutputFormat fmt)
+    : format(fmt), header_written(false) {
+    buffer.reserve(1 << 16);
+}
+
+void StatsSerializer::append(const SystemStats& stats, double timestamp) {
+    if (format == MtopConfig::OutputFormat::CSV) {
+        appendCsv(stats, timestamp);
+    } else {
+        appendJson(stats, timestamp);
+    }
+}
+
+void StatsSerializer::appendJson(const SystemStats& stats, double timestamp) {
+    buffer += "{\"timestamp\":";
+    appendNumber(timestamp, 3);
+    buffer += ",\"cpu_percent\":";
+    appendNumber(stats.cpu_percent, 1);
+    buffer += ",\"cpu_cores\":[";
+    for (size_t i = 0; i < stats.core_percent.size(); ++i) {
+        if (i > 0) buffer += ',';
+        appendNumber(stats.core_percent[i], 1);
+    }
+    buffer += "],\"cpu_breakdown\":{\"user\":";
+    const CpuBreakdown& cpu = stats.cpu_breakdown;
+    appendNumber(cpu.user, 1);
+    buffer += ",\"nice\":";
+    appendNumber(cpu.nice, 1);
+    buffer += ",\"system\":";
+    appendNumber(cpu.system, 1);
+    buffer += ",\"idle\":";
+    appendNumber(cpu.idle, 1);
+    buffer += ",\"iowait\":";
+    appendNumber(cpu.iowait, 1);
+    buffer += ",\"irq\":";
+    appendNumber(cpu.irq, 1);
+    buffer += ",\"softirq\":";
+    appendNumber(cpu.softirq, 1);
+    buffer += ",\"steal\":";
+    appendNumber(cpu.steal, 1);
+    buffer += ",\"guest\":";
+    appendNumber(cpu.guest, 1);
+    buffer += "},\"context_switches_per_sec\":";
+    appendNumber(stats.context_switches_per_sec, 1);
+    buffer += ",\"interrupts_per_sec\":";
+    appendNumber(stats.interrupts_per_sec, 1);
+    buffer += ",\"forks_per_sec\":";
+    appendNumber(stats.forks_per_sec, 1);
+    buffer += ",\"procs_running\":";
+    appendNumber(static_cast<int64_t>(stats.procs_running));
+    buffer += ",\"procs_blocked\":";
+    appendNumber(static_cast<int64_t>(stats.procs_blocked));
+    buffer += ",\"memory\":{\"total_kb\":";
+    appendNumber(stats.total_memory_kb);
+    buffer += ",\"used_kb\":";
+    appendNumber(stats.used_memory_kb);
+    buffer += ",\"free_kb\":";
+    appendNumber(stats.free_memory_kb);
+    const MemInfo& mem = stats.memory_detail;
+    buffer += ",\"buffers_kb\":";
+    appendNumber(mem.buffers_kb);
+    buffer += ",\"cached_kb\":";
+    appendNumber(mem.cached_kb);
+    buffer += ",\"shmem_kb\":";
+    appendNumber(mem.shmem_kb);
+    buffer += ",\"slab_kb\":";
+    appendNumber(mem.slab_kb);
+    buffer += ",\"dirty_kb\":";
+    appendNumber(mem.dirty_kb);
+    buffer += ",\"writeback_kb\":";
+    appendNumber(mem.writeback_kb);
+    buffer += ",\"swap_total_kb\":";
+    appendNumber(mem.swap_total_kb);
+    buffer += ",\"swap_free_kb\":";
+    appendNumber(mem.swap_free_kb);
+    buffer += ",\"hugepages_total\":";
+    appendNumber(mem.hugepages_total);
+    buffer += ",\"hugepages_free\":";
+    appendNumber(mem.hugepages_free);
+    buffer += ",\"hugepage_size_kb\":";
+    appendNumber(mem.hugepage_size_kb);
+    buffer += '}';
+
+    // PSI выводится, только если ядро его поддерживает
+    if (stats.pressure) {
+        buffer += ",\"pressure\":{\"cpu\":";
+        appendPressure(stats.cpu_pressure);
+        buffer += ",\"memory\":";
+        appendPressure(stats.memory_pressure);
+        buffer += ",\"io\":";
+        appendPressure(stats.io_pressure);
+        buffer += '}';
+    }
+    buffer += ",\"load_avg\":[";
+    for (int i = 0; i < 3; ++i) {
+        if (i > 0) buffer += ',';
+        appendNumber(stats.load_avg[i], 2);
+    }
+    buffer += "],\"process_count\":";
+    appendNumber(static_cast<int64_t>(stats.process_count));
+    buffer += ",\"processes\":[";
+
+    bool first = true;
+    for (const auto& proc : stats.processes) {
+        if (!first) buffer += ',';
+        first = false;
+
+        buffer += "{\"pid\":";
+        appendNumber(static_cast<int64_t>(proc.pid));
+        buffer += ",\"ppid\":";
+        appendNumber(static_cast<int64_t>(proc.ppid));
+        buffer += ",\"name\":";
+        appendJsonString(proc.name);
+        buffer += ",\"state\":";
+        appendJsonString(proc.state);
+        buffer += ",\"cpu_percent\":";
+        appendNumber(proc.cpu_percent, 1);
+        buffer += ",\"memory_kb\":";
+        appendNumber(proc.memory_kb);
+        buffer += ",\"user\":";
+        appendJsonString(proc.user);
+        buffer += ",\"uid\":";
+        appendNumber(static_cast<int64_t>(proc.uid));
+        buffer += ",\"kernel_thread\":";
+        buffer += proc.is_kernel_thread ? "true" : "false";
+        if (stats.taskstats) {
+            buffer += ",\"cpu_delay_ms\":";
+            appendNumber(proc.cpu_delay_ns / 1e6, 3);
+            buffer += ",\"blkio_delay_ms\":";
+            appendNumber(proc.blkio_delay_ns / 1e6, 3);
+            buffer += ",\"read_bytes\":";
+            appendNumber(proc.read_bytes);
+            buffer += ",\"write_bytes\":";
+            appendNumber(proc.write_bytes);
+        }
+        if (proc.io) {
+            buffer += ",\"read_bytes_per_sec\":";
+            appendNumber(proc.io_read_rate, 0);
+            buffer += ",\"write_bytes_per_sec\":";
+            appendNumber(proc.io_write_rate, 0);
+            buffer += ",\"rchar_per_sec\":";
+            appendNumber(proc.rchar_rate, 0);
+            buffer += ",\"wchar_per_sec\":";
+            appendNumber(proc.wchar_rate, 0);
+            buffer += ",\"syscr_per_sec\":";
+            appendNumber(proc.syscr_rate, 1);
+            buffer += ",\"syscw_per_sec\":";
+            appendNumber(proc.syscw_rate, 1);
+        }
+        if (proc.smaps) {
+            buffer += ",\"pss_kb\":";
+            appendNumber(proc.pss_kb);
+            buffer += ",\"uss_kb\":";
+            appendNumber(proc.uss_kb);
+            buffer += ",\"swap_kb\":";
+            appendNumber(proc.swap_kb);
+        }
+        if (stats.tree_view) {
+            buffer += ",\"depth\":";
+            appendNumber(static_cast<int64_t>(proc.depth));
+            buffer += ",\"tree_cpu_percent\":";
+            appendNumber(proc.tree_cpu_percent, 1);
+            buffer += ",\"tree_memory_kb\":";
+            appendNumber(proc.tree_memory_kb);
+            buffer += ",\"tree_processes\":";
+            appendNumber(static_cast<int64_t>(proc.tree_processes));
+        }
+        buffer += '}';
+    }
+    buffer += ']';
+
+    // Потоки - только при show_threads
+    if (!stats.threads.empty()) {
+        buffer += ",\"threads\":[";
+        for (size_t i = 0; i < stats.threads.size(); ++i) {
+            const ProcessInfo& thread = stats.threads[i];
+            if (i > 0) buffer += ',';
+            buffer += "{\"tid\":";
+            appendNumber(static_cast<int64_t>(thread.pid));
+            buffer += ",\"pid\":";
+            appendNumber(static_cast<int64_t>(thread.tgid));
+            buffer += ",\"name\":";
+            appendJsonString(thread.name);
+            buffer += ",\"state\":";
+            appendJsonString(thread.state);
+            buffer += ",\"cpu_percent\":";
+            appendNumber(thread.cpu_percent, 1);
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+
+    // Группы cgroup - только при group_by = cgroup
+    if (stats.cgroup_view) {
+        buffer += ",\"cgroups\":[";
+        for (size_t i = 0; i < stats.cgroups.size(); ++i) {
+            const CgroupInfo& group = stats.cgroups[i];
+            if (i > 0) buffer += ',';
+            buffer += "{\"path\":";
+            appendJsonString(group.path);
+            buffer += ",\"processes\":";
+            appendNumber(static_cast<int64_t>(group.process_count));
+            buffer += ",\"cpu_percent\":";
+            appendNumber(group.cpu_percent, 1);
+            buffer += ",\"memory_kb\":";
+            appendNumber(group.memory_kb);
+            buffer += ",\"rss_kb\":";
+            appendNumber(group.rss_kb);
+            if (group.has_pressure) {
+                buffer += ",\"memory_pressure\":";
+                appendPressure(group.memory_pressure);
+            }
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+
+    // Поля proc connector выводятся только когда он активен - формат по умолчанию не меняется
+    if (stats.proc_events) {
+        buffer += ",\"short_lived_count\":";
+        appendNumber(static_cast<int64_t>(stats.short_lived_count));
+        buffer += ",\"short_lived\":[";
+        for (size_t i = 0; i < stats.short_lived.size(); ++i) {
+            const auto& proc = stats.short_lived[i];
+            if (i > 0) buffer += ',';
+            buffer += "{\"pid\":";
+            appendNumber(static_cast<int64_t>(proc.pid));
+            buffer += ",\"ppid\":";
+            appendNumber(static_cast<int64_t>(proc.ppid));
+            buffer += ",\"name\":";
+            appendJsonString(proc.name);
+            buffer += ",\"exit_code\":";
+            appendNumber(static_cast<int64_t>(proc.exit_code));
+            buffer += ",\"lifetime_ms\":";
+            appendNumber(proc.lifetime_ms, 3);
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+
+    buffer += "}\n";
+}
+
+void StatsSerializer::appendCsv(const SystemStats& stats, double timestamp) {
+    // Одна строка на процесс; общесистемные метрики есть только в JSON
+    if (!header_written) {
+        buffer += "timestamp,pid,name,state,cpu_percent,memory_kb,user,uid,kernel_thread\n";
+        header_written = true;
+    }
+
+    for (const auto& proc : stats.processes) {
+        appendNumber(timestamp, 3);
+        buffer += ',';
+        appendNumber(static_cast<int64_t>(proc.pid));
+        buffer += ',';
+        appendCsvField(proc.name);
+        buffer += ',';
+        appendCsvField(proc.state);
+        buffer += ',';
+        appendNumber(proc.cpu_percent, 1);
+        buffer += ',';
+        appendNumber(proc.memory_kb);
+        buffer += ',';
+        appendCsvField(proc.user);
+        buffer += ',';
+        appendNumber(static_cast<int64_t>(proc.uid));
+        buffer += ',';
+        buffer += proc.is_kernel_thread ? '1' : '0';
+        buffer += '\n';
+    }
+}
+
+void StatsSerializer::appendPressure(const PressureInfo& info) {
+    buffer += "{\"some\":[";
+    for (int i = 0; i < 3; ++i) {
+        if (i > 0) buffer += ',';
+        appendNumber(info.some[i], 2);
+    }
+    buffer += "],\"full\":[";
+    for (int i = 0; i < 3; ++i) {
+        if (i > 0) buffer += ',';
+        appendNumber(info.full[i], 2);
+    }
+    buffer += "],\"some_total_us\":";
+    appendNumber(info.some_total);
+    buffer += ",\"full_total_us\":";
+    appendNumber(info.full_total);
+    buffer += '}';
+}
+
+void StatsSerializer::appendNumber(int64_t value) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer.append(buf, result.ptr);
+}
+
+void StatsSerializer::appendNumber(uint64_t value) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    buffer.append(buf, result.ptr);
+}
+
+void StatsSerializer::appendNumber(double value, int precision) {
+    char buf[64];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, precision);
+    buffer.append(buf, result.ptr);
+}
+
+void StatsSerializer::appendJsonString(std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+
+    buffer += '"';
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+
+        if (c == '"' || c == '\\') {
+            buffer += '\\';
+            buffer += static_cast<char>(c);
+            i++;
+        } else if (c < 0x20 || c == 0x7F) {
+            buffer += "\\u00";
+            buffer += hex[c >> 4];
+            buffer += hex[c & 0xF];
+            i++;
+        } else if (c < 0x80) {
+            buffer += static_cast<char>(c);
+            i++;
+        } else {
+            // Имена процессов - произвольные байты: невалидный UTF-8 заменяем на U+FFFD
+            size_t len = (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+            bool valid = len > 0 && i + len <= text.size();
+            for (size_t k = 1; valid && k < len; ++k) {
+                valid = (static_cast<unsigned char>(text[i + k]) & 0xC0) == 0x80;
+            }
+
+            if (valid) {
+                buffer.append(text.data() + i, len);
+                i += len;
+            } else {
+                buffer += "\\ufffd";
+                i++;
+            }
+        }
+    }
+    buffer += '"';
+}
+
+void StatsSerializer::appendCsvField(std::string_view text) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        buffer.append(text.data(), text.size());
+        return;
+    }
+
+    buffer += '"';
+    for (char c : text) {
+        if (c == '"') buffer += '"';
+        buffer += c;
+    }
+    buffer += '"';
+}
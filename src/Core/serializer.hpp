@@ -0,0 +1,38 @@
+#ifndef SERIALIZER_HPP
+#define SERIALIZER_HPP
+
+#include <string>
+#include <string_view>
+#include "parser.hpp"
+#include "system_info.hpp"
+
+// Serializes SystemStats samples for batch mode: one JSON object per line
+// (JSON Lines) or CSV rows, one per process. Numbers are formatted with
+// to_chars into a buffer that is reused between samples.
+class StatsSerializer {
+public:
+    explicit StatsSerializer(MtopConfig::OutputFormat format);
+
+    // Appends one sample; timestamp is seconds since the epoch
+    void append(const SystemStats& stats, double timestamp);
+
+    const std::string& data() const { return buffer; }
+    void clear() { buffer.clear(); }
+
+private:
+    MtopConfig::OutputFormat format;
+    std::string buffer;
+    bool header_written;
+
+    void appendJson(const SystemStats& stats, double timestamp);
+    void appendCsv(const SystemStats& stats, double timestamp);
+
+    void appendPressure(const PressureInfo& info);
+    void appendNumber(int64_t value);
+    void appendNumber(uint64_t value);
+    void appendNumber(double value, int precision);
+    void appendJsonString(std::string_view text);
+    void appendCsvField(std::string_view text);
+};
+
+#endif // SERIALIZER_HPP
@@ -1,51 +1,273 @@
 #include "system_info.hpp"
-#include <fstream>
-#include <sstream>
+#include "proc_parser.hpp"
+#include "taskstats.hpp"
+#include <string_view>
 #include <algorithm>
-#include <filesystem>
-#include <pwd.h>
+#include <cctype>
+#include <thread>
+#include <cerrno>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
 
-SystemInfo::SystemInfo(const MtopConfig& cfg) : config(cfg), prev_total_time(0), prev_idle_time(0) {
+SystemInfo::SystemInfo(const MtopConfig& cfg)
+    : config(cfg), user_cache(cfg.user_cache_ttl), users_pending(false), filter_generation(0), prev_total_time(0), prev_idle_time(0),
+      stat_file("/proc/stat"), meminfo_file("/proc/meminfo"), loadavg_file("/proc/loadavg"),
+      cpu_pressure_file("/proc/pressure/cpu"), memory_pressure_file("/proc/pressure/memory"),
+      io_pressure_file("/proc/pressure/io"),
+      tick(0), total_jiffies(0), cgroup_tick(0), thread_records(64), thread_tick(0) {
+    proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    thread_collector = std::make_unique<ProcfsCollector>(proc_fd);
+    
+    // Под кэш дескрипторов /proc/PID/stat отдаем половину лимита RLIMIT_NOFILE
+    struct rlimit limit;
+    fd_budget = 0;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        fd_budget = static_cast<size_t>(limit.rlim_cur / 2);
+    } else {
+        fd_budget = 4096;
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    num_cpus = cpus > 0 ? static_cast<int>(cpus) : 1;
+    compileNameFilter();
+    compileFilterExpressions();
+    resolveFilterUsers(true);
+    configureCollector();
+    configureProcEvents();
+    configureCgroups();
     updateStats();
 }
 
-SystemStats SystemInfo::getStats() {
-    return stats;
+SystemInfo::~SystemInfo() {
+    records.forEach([](int, ProcessRecord& record) {
+        if (record.stat_fd >= 0) {
+            close(record.stat_fd);
+        }
+    });
+    if (proc_fd >= 0) {
+        close(proc_fd);
+    }
+}
+
+std::shared_ptr<const SystemStats> SystemInfo::getStats() const {
+    return snapshot;
 }
 
 void SystemInfo::updateConfig(const MtopConfig& new_config) {
     config = new_config;
+    user_cache.setTtl(config.user_cache_ttl);
+    compileNameFilter();
+    compileFilterExpressions();
+    resolveFilterUsers(false);
+    configureCollector();
+    configureProcEvents();
+    configureCgroups();
+}
+
+void SystemInfo::configureCollector() {
+    size_t threads = 1;
+    if (config.collector_threads > 0) {
+        threads = static_cast<size_t>(config.collector_threads);
+    } else if (config.collector_threads == 0) {
+        // 0 - автоматически, но без смысла держать больше 8 потоков на /proc
+        threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), 8);
+    }
+    
+    if (!pool || pool->size() != threads) {
+        pool = std::make_unique<CollectorPool>(threads);
+    }
+    
+    if (!collector || collector_kind != config.collector) {
+        collector.reset();
+        collector_kind = config.collector;
+        collector_error.clear();
+        stats.taskstats = false;
+        
+        // auto выбирает taskstats, если ядро и права позволяют, молча
+        if (collector_kind != MtopConfig::Collector::PROCFS) {
+            auto taskstats = std::make_unique<TaskstatsCollector>(proc_fd);
+            std::string error;
+            if (taskstats->open(error)) {
+                collector = std::move(taskstats);
+                stats.taskstats = true;
+            } else if (collector_kind == MtopConfig::Collector::TASKSTATS) {
+                collector_error = error;
+            }
+        }
+        if (!collector) {
+            collector = std::make_unique<ProcfsCollector>(proc_fd);
+        }
+        
+        // Кэш дескрипторов stat нужен только сборщику procfs
+        if (!collector->usesStatFds()) {
+            records.forEach([this](int, ProcessRecord& record) {
+                releaseStatFd(record);
+            });
+        }
+    }
+    collector->prepare(pool->size());
+}
+
+void SystemInfo::configureProcEvents() {
+    proc_events.setListLimit(static_cast<size_t>(std::max(0, config.short_lived_list)));
+    
+    if (!config.proc_events) {
+        proc_events.close();
+        proc_events_error.clear();
+        return;
+    }
+    if (proc_events.isOpen()) return;
+    
+    // Без CAP_NET_ADMIN остаемся на обходе /proc
+    proc_events_error.clear();
+    if (proc_events.open(proc_events_error)) {
+        // Подписка раньше листинга; события, пришедшие во время обхода,
+        // resync() накладывает поверх него
+        proc_events.beginResync();
+        listProcPids(proc_fd, pids);
+        proc_events.resync(pids);
+    }
+}
+
+void SystemInfo::configureCgroups() {
+    cgroup_error.clear();
+    if (config.group_by != MtopConfig::GroupBy::CGROUP) {
+        cgroup_monitor.clear();
+        cgroup_tick = 0;
+        return;
+    }
+    if (!cgroup_monitor.available()) {
+        cgroup_error = "cgroup v2 hierarchy is not mounted";
+    }
+}
+
+void SystemInfo::listPids() {
+    stats.proc_events = proc_events.isOpen();
+    stats.short_lived_count = 0;
+    stats.short_lived.clear();
+    
+    if (!proc_events.isOpen()) {
+        listProcPids(proc_fd, pids);
+        return;
+    }
+    
+    // События потеряны при переполнении буфера - сверяемся с /proc целиком
+    if (!proc_events.drain()) {
+        proc_events.beginResync();
+        listProcPids(proc_fd, pids);
+        proc_events.resync(pids);
+    } else {
+        proc_events.livePids(pids);
+    }
+    
+    stats.short_lived_count = proc_events.shortLivedCount();
+    stats.short_lived = proc_events.shortLived();
 }
 
 void SystemInfo::updateStats() {
+    user_cache.revalidate();
     readCpuStats();
     readMemoryStats();
     readLoadAverage();
+    readPressure();
     readProcesses();
+    readCgroups();
+    rebuildView();
+}
+
+void SystemInfo::rebuildView() {
     applyProcessFilters();
-    sortProcesses();
+    readIoCandidates();
+    if (stats.tree_view) {
+        buildTree();
+    } else {
+        selectTopProcesses();
+    }
+    readShownIo();
+    readSmaps();
+    readThreads();
+    selectTopCgroups();
+    publishSnapshot();
 }
 
 void SystemInfo::readCpuStats() {
-    std::ifstream file("/proc/stat");
-    std::string line;
+    ssize_t len = stat_file.read(read_buf);
+    if (len <= 0) return;
     
-    if (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string cpu_label;
-        uint64_t user, nice, system, idle, iowait, irq, softirq, steal;
-        
-        iss >> cpu_label >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
-        
-        uint64_t total_time = user + nice + system + idle + iowait + irq + softirq + steal;
-        uint64_t idle_time = idle + iowait;
-        
-        stats.cpu_percent = calculateCpuPercent(total_time, idle_time);
-        
-        prev_total_time = total_time;
-        prev_idle_time = idle_time;
+    // Один проход по /proc/stat: общая строка cpu, строки cpuN и счетчики ядра
+    if (!parseKernelStat(read_buf.data(), static_cast<size_t>(len), kernel_stat)) return;
+    auto now = std::chrono::steady_clock::now();
+    
+    // Проценты всех ядер считаются одним проходом по массивам
+    if (kernel_stat.cores.ids == prev_kernel_stat.cores.ids) {
+        computeCpuPercents(kernel_stat.cores, prev_kernel_stat.cores, stats.core_percent);
+    } else {
+        // Первый тик или CPU включили/выключили - дельты не с чем считать
+        stats.core_percent.assign(kernel_stat.cores.size(), 0.0f);
     }
+    
+    // guest уже входит в user, guest_nice - в nice: в сумму их не добавляем
+    const uint64_t* cpu = kernel_stat.cpu;
+    uint64_t total_time = 0;
+    for (int field = CpuTimes::USER; field <= CpuTimes::STEAL; ++field) {
+        total_time += cpu[field];
+    }
+    uint64_t idle_time = cpu[CpuTimes::IDLE] + cpu[CpuTimes::IOWAIT];
+    
+    stats.cpu_percent = calculateCpuPercent(total_time, idle_time);
+    calculateCpuBreakdown(total_time);
+    calculateKernelRates(std::chrono::duration<double>(now - prev_stat_time).count());
+    
+    // Счетчик jiffies на момент чтения нужен для расчета CPU% каждого процесса
+    total_jiffies = total_time;
+    
+    prev_total_time = total_time;
+    prev_idle_time = idle_time;
+    prev_stat_time = now;
+    std::swap(kernel_stat, prev_kernel_stat);
+}
+
+void SystemInfo::calculateCpuBreakdown(uint64_t total_time) {
+    CpuBreakdown& out = stats.cpu_breakdown;
+    out = CpuBreakdown();
+    if (prev_total_time == 0 || total_time <= prev_total_time) return;
+    
+    // iowait на некоторых ядрах убывает - отрицательную дельту считаем нулем
+    const uint64_t* cpu = kernel_stat.cpu;
+    const uint64_t* prev = prev_kernel_stat.cpu;
+    auto delta = [cpu, prev](int field) {
+        return cpu[field] > prev[field] ? cpu[field] - prev[field] : 0;
+    };
+    
+    double scale = 100.0 / static_cast<double>(total_time - prev_total_time);
+    uint64_t guest = delta(CpuTimes::GUEST);
+    uint64_t guest_nice = delta(CpuTimes::GUEST_NICE);
+    out.user = static_cast<double>(delta(CpuTimes::USER) - std::min(guest, delta(CpuTimes::USER))) * scale;
+    out.nice = static_cast<double>(delta(CpuTimes::NICE) - std::min(guest_nice, delta(CpuTimes::NICE))) * scale;
+    out.system = static_cast<double>(delta(CpuTimes::SYSTEM)) * scale;
+    out.idle = static_cast<double>(delta(CpuTimes::IDLE)) * scale;
+    out.iowait = static_cast<double>(delta(CpuTimes::IOWAIT)) * scale;
+    out.irq = static_cast<double>(delta(CpuTimes::IRQ)) * scale;
+    out.softirq = static_cast<double>(delta(CpuTimes::SOFTIRQ)) * scale;
+    out.steal = static_cast<double>(delta(CpuTimes::STEAL)) * scale;
+    out.guest = static_cast<double>(guest + guest_nice) * scale;
+}
+
+void SystemInfo::calculateKernelRates(double elapsed) {
+    stats.procs_running = static_cast<int>(kernel_stat.procs_running);
+    stats.procs_blocked = static_cast<int>(kernel_stat.procs_blocked);
+    
+    stats.context_switches_per_sec = 0.0;
+    stats.interrupts_per_sec = 0.0;
+    stats.forks_per_sec = 0.0;
+    if (prev_total_time == 0 || elapsed <= 0.0) return;
+    
+    auto rate = [elapsed](uint64_t now, uint64_t before) {
+        return now > before ? static_cast<double>(now - before) / elapsed : 0.0;
+    };
+    stats.context_switches_per_sec = rate(kernel_stat.context_switches, prev_kernel_stat.context_switches);
+    stats.interrupts_per_sec = rate(kernel_stat.interrupts, prev_kernel_stat.interrupts);
+    stats.forks_per_sec = rate(kernel_stat.forks, prev_kernel_stat.forks);
 }
 
 double SystemInfo::calculateCpuPercent(uint64_t total_time, uint64_t idle_time) {
@@ -60,195 +282,838 @@ double SystemInfo::calculateCpuPercent(uint64_t total_time, uint64_t idle_time)
 }
 
 void SystemInfo::readMemoryStats() {
-    std::ifstream file("/proc/meminfo");
-    std::string line;
+    ssize_t len = meminfo_file.read(read_buf);
+    if (len <= 0 || !parseMemInfo(read_buf.data(), static_cast<size_t>(len), stats.memory_detail)) {
+        stats.memory_detail = MemInfo();
+    }
     
-    stats.total_memory_kb = 0;
-    stats.free_memory_kb = 0;
-    uint64_t available_kb = 0;
+    // MemAvailable есть с 3.14; на старых ядрах свободной считаем MemFree
+    const MemInfo& mem = stats.memory_detail;
+    stats.total_memory_kb = mem.total_kb;
+    stats.free_memory_kb = mem.available_kb > 0 ? mem.available_kb : mem.free_kb;
+    stats.used_memory_kb = stats.total_memory_kb - stats.free_memory_kb;
+}
+
+void SystemInfo::readLoadAverage() {
+    ssize_t len = loadavg_file.read(read_buf);
+    if (len <= 0) return;
     
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        uint64_t value;
+    const char* p = read_buf.data();
+    const char* end = p + len;
+    for (double& load : stats.load_avg) {
+        p = parseNextNumber(p, end, load);
+        if (!p) return;
+    }
+}
+
+void SystemInfo::readPressure() {
+    // Файлы PSI держим открытыми: опрос - три pread() без open()
+    stats.pressure = cpu_pressure_file.isOpen();
+    if (!stats.pressure) return;
+    
+    ssize_t len = cpu_pressure_file.read(read_buf);
+    if (len <= 0 || !parsePressure(read_buf.data(), static_cast<size_t>(len), stats.cpu_pressure)) {
+        stats.cpu_pressure = PressureInfo();
+    }
+    len = memory_pressure_file.read(read_buf);
+    if (len <= 0 || !parsePressure(read_buf.data(), static_cast<size_t>(len), stats.memory_pressure)) {
+        stats.memory_pressure = PressureInfo();
+    }
+    len = io_pressure_file.read(read_buf);
+    if (len <= 0 || !parsePressure(read_buf.data(), static_cast<size_t>(len), stats.io_pressure)) {
+        stats.io_pressure = PressureInfo();
+    }
+}
+
+bool SystemInfo::shouldReadProcess(const ProcessRecord& record) const {
+    return !record.valid || tick >= record.next_read_tick;
+}
+
+void SystemInfo::updateProcessRecord(ProcessRecord& record) {
+    ProcessInfo& info = record.info;
+    bool same_process = record.valid && sameStartTime(record.start_time, info.start_time);
+    if (!same_process) {
+        info.smaps = false; // данные smaps и io могли остаться от прежнего владельца PID
+        record.smaps_time = std::chrono::steady_clock::time_point();
+        info.io = false;
+        record.io_time = std::chrono::steady_clock::time_point();
+        record.io_denied = false;
+    }
+    record.cpu_active = !same_process || info.cpu_time != record.cpu_time;
+    
+    // Дельта считается от прошлого чтения этого процесса, а не от прошлого тика:
+    // при бэкоффе между чтениями проходит несколько тиков
+    double percent = 0.0;
+    if (same_process && info.cpu_time >= record.cpu_time && total_jiffies > record.sample_jiffies) {
+        // 100% соответствует одному полностью загруженному ядру, как в top
+        double elapsed_per_cpu = static_cast<double>(total_jiffies - record.sample_jiffies) / num_cpus;
+        percent = 100.0 * static_cast<double>(info.cpu_time - record.cpu_time) / elapsed_per_cpu;
+    }
+    info.cpu_percent = percent;
+    
+    // Процесс без изменений CPU и RSS idle_backoff_ticks чтений подряд читаем реже
+    if (same_process && info.cpu_time == record.cpu_time && info.memory_kb == record.memory_kb) {
+        record.idle_reads++;
+    } else {
+        record.idle_reads = 0;
+    }
+    int backoff = config.idle_backoff_ticks;
+    record.next_read_tick = tick + ((backoff > 0 && record.idle_reads >= backoff) ? backoff : 1);
+    
+    record.cpu_time = info.cpu_time;
+    record.start_time = info.start_time;
+    record.memory_kb = info.memory_kb;
+    record.sample_jiffies = total_jiffies;
+    record.valid = true;
+}
+
+void SystemInfo::readProcesses() {
+    tick++;
+    
+    listPids();
+    
+    bool stat_fds = collector->usesStatFds();
+    scanRecords(records, pids, nullptr, *collector, stat_fds);
+    
+    updateStatFdCache();
+    
+    int count = 0;
+    records.forEach([&count](int, ProcessRecord& record) {
+        if (record.valid) count++;
+    });
+    stats.process_count = count;
+    
+    // Процессы без exec() носят имя родителя
+    for (auto& proc : stats.short_lived) {
+        if (!proc.name.empty()) continue;
+        const ProcessRecord* parent = records.find(proc.ppid);
+        if (parent && parent->valid) proc.name = parent->info.name;
+    }
+}
+
+void SystemInfo::scanRecords(PidTable<ProcessRecord>& table, const std::vector<int>& ids,
+                             const std::vector<int>* owners, ProcessCollector& source, bool stat_fds) {
+    // Новые ID и исчезнувшие находим по списку каталога. Таблица растет и
+    // сдвигает записи только здесь, до того как задачи получат указатели на них
+    for (int pid : ids) {
+        bool inserted = false;
+        ProcessRecord& record = table.insert(pid, inserted);
+        record.seen_tick = tick;
+    }
+    table.sweep([this](int, ProcessRecord& record) {
+        if (record.seen_tick == tick) return true;
+        releaseStatFd(record);
+        return false;
+    });
+    
+    // Читаем только то, что могло измениться; бэкофф пропускает простаивающие процессы
+    tasks.clear();
+    task_records.clear();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        int pid = ids[i];
+        ProcessRecord* record = table.find(pid);
+        if (!shouldReadProcess(*record)) {
+            record->info.cpu_percent = 0.0;
+            record->cpu_active = false;
+            continue;
+        }
         
-        iss >> key >> value;
+        // UID может смениться после старта (setuid) - перепроверяем раз в 16 тиков, вразнобой
+        bool check_uid = !record->valid || (static_cast<uint64_t>(pid) + tick) % 16 == 0;
+        int fd = stat_fds ? record->stat_fd : -1;
+        int tgid = owners ? (*owners)[i] : 0;
+        tasks.push_back(ProcScanTask{pid, tgid, fd, -1, fd >= 0, false, &record->info, check_uid, false});
+        task_records.push_back(record);
+    }
+    if (stat_fds) {
+        reserveStatFdSlots();
+    }
+    
+    // Каждая задача обновляет свою запись, блокировки не нужны
+    pool->run(tasks.size(), [this, &source](size_t worker, size_t begin, size_t end) {
+        source.collect(worker, tasks.data() + begin, end - begin);
+    });
+    
+    // Расчет CPU% в одном потоке
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (tasks[i].ok) {
+            updateProcessRecord(*task_records[i]);
+        } else {
+            task_records[i]->valid = false; // процесс завершается или недоступен
+            task_records[i]->cpu_active = false;
+        }
+    }
+}
+
+void SystemInfo::readThreads() {
+    if (!config.show_threads || stats.cgroup_view) {
+        if (thread_records.size() > 0) {
+            thread_records.sweep([](int, ProcessRecord&) { return false; });
+        }
+        thread_groups.clear();
+        thread_tick = 0;
+        return;
+    }
+    
+    // Потоки читаются раз за тик. Пересборка вида в том же тике (фильтр,
+    // сортировка) берет их из таблицы, а дочитывает только процессы, которые
+    // раньше не показывались: повторное чтение дало бы нулевой интервал CPU%
+    bool rebuild = thread_tick == tick;
+    thread_tick = tick;
+    size_t first_new = 0;
+    if (rebuild) {
+        shown_pids.clear();
+        for (const ProcessInfo* proc : view) {
+            shown_pids.push_back(proc->pid);
+        }
+        std::sort(shown_pids.begin(), shown_pids.end());
         
-        if (key == "MemTotal:") {
-            stats.total_memory_kb = value;
-        } else if (key == "MemAvailable:") {
-            available_kb = value;
-        } else if (key == "MemFree:" && available_kb == 0) {
-            stats.free_memory_kb = value;
+        // Группы скрытых строк выбрасываем, а их TID вырезаем: на каждое нажатие
+        // в '/' приходится пересборка, массивы не должны расти до конца тика.
+        // Диапазоны групп идут по возрастанию, поэтому сдвиг влево на месте
+        size_t kept = 0;
+        size_t next = 0;
+        grouped_pids.clear();
+        for (const ThreadGroup& group : thread_groups) {
+            if (!std::binary_search(shown_pids.begin(), shown_pids.end(), group.pid)) continue;
+            size_t count = group.end - group.begin;
+            std::copy(thread_ids.begin() + static_cast<std::ptrdiff_t>(group.begin),
+                      thread_ids.begin() + static_cast<std::ptrdiff_t>(group.end),
+                      thread_ids.begin() + static_cast<std::ptrdiff_t>(next));
+            std::copy(thread_owners.begin() + static_cast<std::ptrdiff_t>(group.begin),
+                      thread_owners.begin() + static_cast<std::ptrdiff_t>(group.end),
+                      thread_owners.begin() + static_cast<std::ptrdiff_t>(next));
+            thread_groups[kept++] = ThreadGroup{group.pid, next, next + count};
+            grouped_pids.push_back(group.pid);
+            next += count;
         }
+        thread_groups.resize(kept);
+        thread_ids.resize(next);
+        thread_owners.resize(next);
+        std::sort(grouped_pids.begin(), grouped_pids.end());
+        first_new = next;
+    } else {
+        thread_ids.clear();
+        thread_owners.clear();
+        thread_groups.clear();
     }
     
-    if (available_kb > 0) {
-        stats.free_memory_kb = available_kb;
+    // TID показанных процессов - из /proc/PID/task, однопоточные пропускаем
+    char path[32];
+    for (const ProcessInfo* proc : view) {
+        if (proc->threads == 1 || proc->is_kernel_thread) continue;
+        if (rebuild && std::binary_search(grouped_pids.begin(), grouped_pids.end(), proc->pid)) continue;
+        
+        snprintf(path, sizeof(path), "%d/task", proc->pid);
+        int fd = openat(proc_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) continue;
+        bool listed = listProcPids(fd, task_ids);
+        close(fd);
+        if (!listed) continue;
+        
+        size_t begin = thread_ids.size();
+        thread_ids.insert(thread_ids.end(), task_ids.begin(), task_ids.end());
+        thread_owners.resize(thread_ids.size(), proc->pid);
+        thread_groups.push_back(ThreadGroup{proc->pid, begin, thread_ids.size()});
     }
     
-    stats.used_memory_kb = stats.total_memory_kb - stats.free_memory_kb;
+    // Тот же разбор stat без аллокаций и та же таблица дельт, что у процессов,
+    // но из /proc/PID/task/TID/stat; дескрипторы потоков не кэшируются.
+    // При пересборке - только новые TID: записи, прочитанные в этом тике,
+    // переживают sweep по seen_tick
+    if (!rebuild) {
+        scanRecords(thread_records, thread_ids, &thread_owners, *thread_collector, false);
+    } else if (first_new < thread_ids.size()) {
+        rescan_ids.assign(thread_ids.begin() + static_cast<std::ptrdiff_t>(first_new), thread_ids.end());
+        rescan_owners.assign(thread_owners.begin() + static_cast<std::ptrdiff_t>(first_new), thread_owners.end());
+        scanRecords(thread_records, rescan_ids, &rescan_owners, *thread_collector, false);
+    }
 }
 
-void SystemInfo::readLoadAverage() {
-    std::ifstream file("/proc/loadavg");
-    if (file.is_open()) {
-        file >> stats.load_avg[0] >> stats.load_avg[1] >> stats.load_avg[2];
+void SystemInfo::readCgroups() {
+    if (config.group_by != MtopConfig::GroupBy::CGROUP || !cgroup_monitor.available()) return;
+    
+    // Процессы переносят между группами редко: путь читаем у новых процессов,
+    // после переиспользования PID и раз в cgroup_recheck_ticks тиков, вразнобой
+    constexpr uint64_t cgroup_recheck_ticks = 32;
+    cgroup_records.clear();
+    records.forEach([this](int pid, ProcessRecord& record) {
+        if (!record.valid) return;
+        if (record.cgroup.empty() || !sameStartTime(record.cgroup_start_time, record.start_time) ||
+            (static_cast<uint64_t>(pid) + tick) % cgroup_recheck_ticks == 0) {
+            cgroup_records.push_back(&record);
+        }
+    });
+    pool->run(cgroup_records.size(), [this](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ProcessRecord& record = *cgroup_records[i];
+            if (CgroupMonitor::readProcessCgroup(record.info.pid, record.cgroup)) {
+                record.cgroup_start_time = record.start_time;
+            } else {
+                record.cgroup.clear(); // процесс завершился - в группы не попадет
+            }
+        }
+    });
+    
+    // Группы живы, пока в них есть процессы; файлы читаются один раз за тик
+    records.forEach([this](int, ProcessRecord& record) {
+        record.group = nullptr;
+        if (record.valid && !record.cgroup.empty()) {
+            record.group = &cgroup_monitor.touch(record.cgroup, tick);
+        }
+    });
+    cgroup_monitor.refresh(tick);
+    cgroup_tick = tick;
+}
+
+void SystemInfo::readIoCandidates() {
+    if (config.sort_by != MtopConfig::SortBy::IO) return;
+    
+    // Для выбора top-K по I/O нужны скорости до сортировки, но читать io всех
+    // процессов - второй полный скан. Процесс без прироста CPU-времени почти
+    // не делал системных вызовов: его не читаем и считаем скорость нулевой.
+    // Счетчики накопительные - его I/O попадет в дельту следующего чтения
+    io_records.clear();
+    for (const ProcessInfo* proc : view) {
+        ProcessRecord* record = records.find(proc->pid);
+        if (!record || record->io_denied || record->io_tick == tick) continue;
+        
+        bool baseline = record->io_time != std::chrono::steady_clock::time_point();
+        if (record->cpu_active || !baseline) {
+            io_records.push_back(record);
+        } else {
+            ProcessInfo& info = record->info;
+            info.io = true;
+            info.io_read_rate = info.io_write_rate = 0.0;
+            info.rchar_rate = info.wchar_rate = 0.0;
+            info.syscr_rate = info.syscw_rate = 0.0;
+        }
     }
+    readProcessIo();
 }
 
-void SystemInfo::readProcesses() {
-    stats.processes.clear();
-    stats.process_count = 0;
+void SystemInfo::readShownIo() {
+    if (!config.show_process_io) return;
     
-    try {
-        for (const auto& entry : std::filesystem::directory_iterator("/proc")) {
-            if (!entry.is_directory()) continue;
-            
-            std::string filename = entry.path().filename().string();
-            if (!std::all_of(filename.begin(), filename.end(), ::isdigit)) continue;
-            
-            int pid = std::stoi(filename);
-            ProcessInfo proc;
-            proc.pid = pid;
-            proc.is_kernel_thread = false;
-            
-            // Читаем /proc/PID/stat
-            std::ifstream stat_file("/proc/" + filename + "/stat");
-            if (!stat_file.is_open()) continue;
-            
-            std::string stat_line;
-            std::getline(stat_file, stat_line);
-            
-            // Парсим строку stat правильно - имя процесса может содержать пробелы в скобках
-            size_t first_paren = stat_line.find('(');
-            size_t last_paren = stat_line.rfind(')');
+    // Показанные строки читаются каждый тик; новая строка получает скорость со второго
+    io_records.clear();
+    for (const ProcessInfo* proc : view) {
+        ProcessRecord* record = records.find(proc->pid);
+        if (record && !record->io_denied && record->io_tick != tick) {
+            io_records.push_back(record);
+        }
+    }
+    readProcessIo();
+}
+
+void SystemInfo::readProcessIo() {
+    if (io_records.empty()) return;
+    
+    auto now = std::chrono::steady_clock::now();
+    pool->run(io_records.size(), [this, now](size_t, size_t begin, size_t end) {
+        char path[64];
+        char buf[1024];
+        for (size_t i = begin; i < end; ++i) {
+            ProcessRecord& record = *io_records[i];
+            ProcessInfo& info = record.info;
+            record.io_tick = tick;
             
-            if (first_paren == std::string::npos || last_paren == std::string::npos) {
+            ProcIo io;
+            ssize_t len = formatProcPath(path, sizeof(path), info.pid, "io")
+                              ? readProcFile(path, buf, sizeof(buf)) : -1;
+            if (len <= 0 || !parseProcIo(buf, static_cast<size_t>(len), io)) {
+                // EACCES - чужой процесс без CAP_SYS_PTRACE, повторять бессмысленно
+                record.io_denied = len < 0 && errno == EACCES;
+                info.io = false;
                 continue;
             }
             
-            // Извлекаем имя процесса (между скобками)
-            proc.name = stat_line.substr(first_paren + 1, last_paren - first_paren - 1);
-            
-            // Парсим остальные поля после закрывающей скобки
-            std::string remaining = stat_line.substr(last_paren + 1);
-            std::istringstream iss(remaining);
-            
-            std::vector<std::string> fields;
-            std::string field;
-            while (iss >> field) {
-                fields.push_back(field);
-            }
-            
-            if (fields.size() >= 22) {
-                proc.state = fields[0]; // Первое поле после имени - состояние
-                
-                // Проверяем, является ли процесс kernel thread
-                int ppid = std::stoi(fields[1]);
-                if (ppid == 2 || (proc.name.front() == '[' && proc.name.back() == ']')) {
-                    proc.is_kernel_thread = true;
-                }
-                
-                // RSS находится в поле 21 (после имени и состояния)
-                uint64_t rss = std::stoull(fields[21]);
-                proc.memory_kb = rss * 4; // RSS в страницах по 4KB
-            } else {
-                continue; // Пропускаем процесс если данных недостаточно
+            double elapsed = std::chrono::duration<double>(now - record.io_time).count();
+            info.io = record.io_time != std::chrono::steady_clock::time_point() && elapsed > 0.0;
+            if (info.io) {
+                auto rate = [elapsed](uint64_t value, uint64_t before) {
+                    return value > before ? static_cast<double>(value - before) / elapsed : 0.0;
+                };
+                info.io_read_rate = rate(io.read_bytes, record.io.read_bytes);
+                info.io_write_rate = rate(io.write_bytes, record.io.write_bytes);
+                info.rchar_rate = rate(io.rchar, record.io.rchar);
+                info.wchar_rate = rate(io.wchar, record.io.wchar);
+                info.syscr_rate = rate(io.syscr, record.io.syscr);
+                info.syscw_rate = rate(io.syscw, record.io.syscw);
             }
-            
-            // Читаем /proc/PID/status для получения UID
-            std::ifstream status_file("/proc/" + filename + "/status");
-            std::string status_line;
-            proc.uid = 0;
-            
-            while (std::getline(status_file, status_line)) {
-                if (status_line.substr(0, 4) == "Uid:") {
-                    std::istringstream uid_iss(status_line);
-                    std::string uid_label;
-                    uid_iss >> uid_label >> proc.uid;
-                    break;
-                }
+            record.io = io;
+            record.io_time = now;
+        }
+    });
+}
+
+void SystemInfo::readSmaps() {
+    if (config.memory_accounting != MtopConfig::MemoryAccounting::PSS) return;
+    
+    // smaps_rollup обходит все отображения процесса - читаем только показанные
+    // строки: сначала те, у которых данных еще нет, затем устаревшие, сверху вниз
+    auto now = std::chrono::steady_clock::now();
+    auto max_age = std::chrono::duration<double>(config.smaps_max_age);
+    size_t limit = config.smaps_reads_per_tick > 0 ? static_cast<size_t>(config.smaps_reads_per_tick)
+                                                   : view.size();
+    smaps_records.clear();
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const ProcessInfo* proc : view) {
+            if (smaps_records.size() >= limit) break;
+            ProcessRecord* record = records.find(proc->pid);
+            if (!record) continue;
+            bool never = record->smaps_time == std::chrono::steady_clock::time_point();
+            if (pass == 0 ? never : !never && now - record->smaps_time >= max_age) {
+                smaps_records.push_back(record);
             }
-            
-            proc.user = getUserName(proc.uid);
-            proc.cpu_percent = 0.0; // Упрощенная версия, без вычисления CPU
-            
-            stats.processes.push_back(proc);
-            stats.process_count++;
         }
-    } catch (const std::exception&) {
-        // Игнорируем ошибки чтения процессов
+    }
+    if (smaps_records.empty()) return;
+    
+    pool->run(smaps_records.size(), [this](size_t, size_t begin, size_t end) {
+        char path[64];
+        char buf[4096];
+        for (size_t i = begin; i < end; ++i) {
+            ProcessInfo& info = smaps_records[i]->info;
+            SmapsRollup rollup;
+            ssize_t len = formatProcPath(path, sizeof(path), info.pid, "smaps_rollup")
+                              ? readProcFile(path, buf, sizeof(buf)) : -1;
+            // Чужие процессы без CAP_SYS_PTRACE недоступны - остаются с RSS
+            info.smaps = len > 0 && parseSmapsRollup(buf, static_cast<size_t>(len), rollup);
+            info.pss_kb = rollup.pss_kb;
+            info.uss_kb = rollup.ussKb();
+            info.swap_kb = rollup.swap_kb;
+        }
+    });
+    
+    // Неудачная попытка тоже считается чтением: не повторяем ее каждый тик
+    for (ProcessRecord* record : smaps_records) {
+        record->smaps_time = now;
+    }
+    
+    // Выбраны строки по PSS там, где он уже был, и по RSS у остальных - досортировываем.
+    // В дереве порядок строк - прямой обход, publishSnapshot() сопоставляет их
+    // с tree.rows() по индексу; новые PSS учтутся при следующем построении
+    if (config.sort_by == MtopConfig::SortBy::MEMORY && !stats.tree_view) {
+        std::sort(view.begin(), view.end(), [this](const ProcessInfo* a, const ProcessInfo* b) {
+            return compareProcesses(*a, *b);
+        });
     }
 }
 
+void SystemInfo::reserveStatFdSlots() {
+    size_t uncached = 0;
+    for (const auto& task : tasks) {
+        if (task.fd < 0) uncached++;
+    }
+    
+    // Освобождаем место, вытесняя дескрипторы, не читавшиеся в прошлом тике
+    while (fd_lru.size() + uncached > fd_budget && !fd_lru.empty()) {
+        ProcessRecord* oldest = records.find(fd_lru.back());
+        if (oldest && oldest->fd_tick + 1 >= tick) break;
+        if (oldest) {
+            releaseStatFd(*oldest);
+        } else {
+            fd_lru.pop_back();
+        }
+    }
+    
+    // Новые дескрипторы оставляем открытыми только в пределах бюджета
+    size_t free_slots = fd_budget > fd_lru.size() ? fd_budget - fd_lru.size() : 0;
+    for (auto& task : tasks) {
+        if (free_slots == 0) break;
+        if (task.fd < 0) {
+            task.keep = true;
+            free_slots--;
+        }
+    }
+}
+
+void SystemInfo::updateStatFdCache() {
+    for (const auto& task : tasks) {
+        ProcessRecord* record = records.find(task.pid);
+        if (!record || record->stat_fd < 0) continue;
+        
+        if (task.stale) {
+            releaseStatFd(*record);
+        } else {
+            record->fd_tick = tick;
+            fd_lru.splice(fd_lru.begin(), fd_lru, record->lru_pos);
+        }
+    }
+    
+    for (const auto& task : tasks) {
+        if (task.new_fd < 0) continue;
+        
+        ProcessRecord* record = records.find(task.pid);
+        if (!record || record->seen_tick != tick || record->stat_fd >= 0) {
+            close(task.new_fd);
+            continue;
+        }
+        
+        record->stat_fd = task.new_fd;
+        record->fd_tick = tick;
+        fd_lru.push_front(task.pid);
+        record->lru_pos = fd_lru.begin();
+    }
+}
+
+void SystemInfo::releaseStatFd(ProcessRecord& record) {
+    if (record.stat_fd < 0) return;
+    close(record.stat_fd);
+    record.stat_fd = -1;
+    fd_lru.erase(record.lru_pos);
+}
+
 void SystemInfo::applyProcessFilters() {
-    // Фильтруем процессы согласно конфигурации
-    auto it = std::remove_if(stats.processes.begin(), stats.processes.end(),
-                             [this](const ProcessInfo& proc) {
-                                 return !shouldShowProcess(proc);
-                             });
-    stats.processes.erase(it, stats.processes.end());
+    // Фильтруем процессы согласно конфигурации; записи не меняются, в view - указатели
+    view.clear();
+    if (users_pending) {
+        resolveFilterUsers(false);
+    }
     
-    // Ограничиваем количество процессов
-    if (stats.processes.size() > static_cast<size_t>(config.max_processes)) {
-        stats.processes.resize(config.max_processes);
+    // Группы считаются в том же проходе: процесс добавляется к своей группе
+    // по указателю в хэш-таблицу, без сортировки и слияния
+    bool grouped = config.group_by == MtopConfig::GroupBy::CGROUP && cgroup_tick == tick && tick > 0;
+    if (grouped) {
+        cgroup_monitor.resetSums();
+    }
+    records.forEach([this, grouped](int, ProcessRecord& record) {
+        if (record.valid && shouldShowProcess(record)) {
+            view.push_back(&record.info);
+            if (grouped && record.group) {
+                CgroupMonitor::Group& group = *record.group;
+                group.info.process_count++;
+                group.info.rss_kb += record.info.memory_kb;
+                group.process_cpu += record.info.cpu_percent;
+            }
+        }
+    });
+    
+    stats.cgroup_view = grouped;
+    stats.tree_view = config.tree_view && !grouped;
+    stats.cgroups.clear();
+    if (grouped) {
+        cgroup_monitor.collect(stats.cgroups);
     }
 }
 
-bool SystemInfo::shouldShowProcess(const ProcessInfo& proc) const {
+bool SystemInfo::shouldShowProcess(ProcessRecord& record) {
+    const ProcessInfo& proc = record.info;
+    
     // Проверяем kernel threads
     if (proc.is_kernel_thread && !config.show_kernel_threads) {
         return false;
     }
     
-    // Проверяем скрытые процессы
-    for (const auto& hidden : config.hide_processes) {
-        if (proc.name.find(hidden) != std::string::npos) {
+    // Фильтры по имени зависят только от имени: результат хранится в записи
+    // и пересчитывается после перекомпиляции фильтров или смены имени (exec)
+    if (record.filter_generation != filter_generation || record.filter_name != proc.name) {
+        record.filter_generation = filter_generation;
+        record.filter_name = proc.name;
+        record.name_shown = matchesNameFilters(proc.name);
+    }
+    if (!record.name_shown) {
+        return false;
+    }
+    
+    // Проверяем фильтр по пользователям (сравниваем UID, а не имена)
+    if (!config.show_only_users.empty()) {
+        if (!std::binary_search(show_only_uids.begin(), show_only_uids.end(), proc.uid)) {
             return false;
         }
     }
     
-    // Проверяем фильтр по пользователям
-    if (!config.show_only_users.empty()) {
-        bool found = false;
-        for (const auto& user : config.show_only_users) {
-            if (proc.user == user) {
-                found = true;
-                break;
-            }
+    // Выражения вида cpu>5 - по текущим значениям, без кэша
+    for (const auto& expr : filter_expressions) {
+        if (!expr.matches(proc, sortMemoryKb(proc))) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool SystemInfo::matchesNameFilters(const std::string& name) const {
+    // Скрытые процессы: все шаблоны hide_processes за один проход по имени
+    if (hide_matcher.matches(name)) {
+        return false;
+    }
+    
+    // Фильтр по имени без учета регистра (ASCII)
+    if (!name_filter.empty()) {
+        auto it = std::search(name.begin(), name.end(), name_filter.begin(), name_filter.end(),
+                              [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+        if (it == name.end()) {
+            return false;
         }
-        if (!found) return false;
     }
     
     return true;
 }
 
-void SystemInfo::sortProcesses() {
-    std::sort(stats.processes.begin(), stats.processes.end(),
-              [this](const ProcessInfo& a, const ProcessInfo& b) {
-                  bool result = false;
-                  
-                  switch (config.sort_by) {
-                      case MtopConfig::SortBy::MEMORY:
-                          result = a.memory_kb > b.memory_kb;
-                          break;
-                      case MtopConfig::SortBy::CPU:
-                          result = a.cpu_percent > b.cpu_percent;
-                          break;
-                      case MtopConfig::SortBy::PID:
-                          result = a.pid < b.pid;
-                          break;
-                      case MtopConfig::SortBy::NAME:
-                          result = a.name < b.name;
-                          break;
-                  }
-                  
-                  return config.reverse_sort ? !result : result;
-              });
+bool SystemInfo::compareProcesses(const ProcessInfo& a, const ProcessInfo& b) const {
+    // reverse_sort меняет аргументы местами, чтобы сохранить strict weak ordering
+    const ProcessInfo& lhs = config.reverse_sort ? b : a;
+    const ProcessInfo& rhs = config.reverse_sort ? a : b;
+    
+    switch (config.sort_by) {
+        case MtopConfig::SortBy::MEMORY:
+            return sortMemoryKb(lhs) > sortMemoryKb(rhs);
+        case MtopConfig::SortBy::CPU:
+            return lhs.cpu_percent > rhs.cpu_percent;
+        case MtopConfig::SortBy::PID:
+            return lhs.pid < rhs.pid;
+        case MtopConfig::SortBy::NAME:
+            return lhs.name < rhs.name;
+        case MtopConfig::SortBy::IO: {
+            // Диск в приоритете; при равенстве (обычно оба 0) - read()/write() вообще
+            double lhs_disk = lhs.io_read_rate + lhs.io_write_rate;
+            double rhs_disk = rhs.io_read_rate + rhs.io_write_rate;
+            if (lhs_disk != rhs_disk) return lhs_disk > rhs_disk;
+            return lhs.rchar_rate + lhs.wchar_rate > rhs.rchar_rate + rhs.wchar_rate;
+        }
+    }
+    return false;
+}
+
+uint64_t SystemInfo::sortMemoryKb(const ProcessInfo& proc) const {
+    // PSS известен только у недавно показанных строк, у остальных - RSS
+    if (config.memory_accounting == MtopConfig::MemoryAccounting::PSS && proc.smaps) {
+        return proc.pss_kb;
+    }
+    return proc.memory_kb;
+}
+
+void SystemInfo::selectTopProcesses() {
+    auto compare = [this](const ProcessInfo* a, const ProcessInfo* b) {
+        return compareProcesses(*a, *b);
+    };
+    
+    // Частичная сортировка: O(n log k), упорядочиваются только первые K
+    // max_processes = 0 - без ограничения
+    size_t limit = config.max_processes > 0 ? static_cast<size_t>(config.max_processes)
+                                            : view.size();
+    if (limit < view.size()) {
+        std::partial_sort(view.begin(), view.begin() + limit, view.end(), compare);
+        view.resize(limit);
+    } else {
+        std::sort(view.begin(), view.end(), compare);
+    }
+}
+
+bool SystemInfo::compareTreeNodes(int a, int b) const {
+    // Братья сравниваются по итогам поддеревьев: супервизор весит столько,
+    // сколько все его потомки; PID, имя и I/O - по самому процессу
+    const ProcessTree::Node& lhs = tree.node(config.reverse_sort ? b : a);
+    const ProcessTree::Node& rhs = tree.node(config.reverse_sort ? a : b);
+    
+    switch (config.sort_by) {
+        case MtopConfig::SortBy::MEMORY:
+            return lhs.memory_kb > rhs.memory_kb;
+        case MtopConfig::SortBy::CPU:
+            return lhs.cpu_percent > rhs.cpu_percent;
+        case MtopConfig::SortBy::PID:
+            return lhs.pid < rhs.pid;
+        case MtopConfig::SortBy::NAME:
+        case MtopConfig::SortBy::IO:
+            break;
+    }
+    // view еще в порядке узлов дерева
+    return compareProcesses(*view[a], *view[b]);
+}
+
+void SystemInfo::buildTree() {
+    // Построение и итоги - O(n); единственная сортировка упорядочивает
+    // сразу все списки братьев
+    tree.clear();
+    for (const ProcessInfo* proc : view) {
+        tree.add(proc->pid, proc->ppid, proc->cpu_percent, sortMemoryKb(*proc));
+    }
+    tree.link();
+    tree.sortSiblings([this](int a, int b) {
+        return compareTreeNodes(a, b);
+    });
+    
+    // Строки - прямой порядок, обрезанный до max_processes: поддеревья с
+    // наибольшими итогами идут первыми
+    const std::vector<int>& rows = tree.rows();
+    size_t limit = config.max_processes > 0 ? std::min(rows.size(), static_cast<size_t>(config.max_processes))
+                                            : rows.size();
+    tree_view.clear();
+    for (size_t i = 0; i < limit; ++i) {
+        tree_view.push_back(view[rows[i]]);
+    }
+    view.swap(tree_view);
+}
+
+bool SystemInfo::compareCgroups(const CgroupInfo& a, const CgroupInfo& b) const {
+    const CgroupInfo& lhs = config.reverse_sort ? b : a;
+    const CgroupInfo& rhs = config.reverse_sort ? a : b;
+    
+    // Сортировка по PID для групп - по числу процессов, по I/O - по CPU
+    switch (config.sort_by) {
+        case MtopConfig::SortBy::MEMORY:
+            return lhs.memory_kb > rhs.memory_kb;
+        case MtopConfig::SortBy::CPU:
+        case MtopConfig::SortBy::IO:
+            return lhs.cpu_percent > rhs.cpu_percent;
+        case MtopConfig::SortBy::PID:
+            return lhs.process_count > rhs.process_count;
+        case MtopConfig::SortBy::NAME:
+            return lhs.path < rhs.path;
+    }
+    return false;
+}
+
+void SystemInfo::selectTopCgroups() {
+    auto compare = [this](const CgroupInfo& a, const CgroupInfo& b) {
+        return compareCgroups(a, b);
+    };
+    
+    std::vector<CgroupInfo>& groups = stats.cgroups;
+    size_t limit = config.max_processes > 0 ? static_cast<size_t>(config.max_processes)
+                                            : groups.size();
+    if (limit < groups.size()) {
+        std::partial_sort(groups.begin(), groups.begin() + limit, groups.end(), compare);
+        groups.resize(limit);
+    } else {
+        std::sort(groups.begin(), groups.end(), compare);
+    }
+}
+
+void SystemInfo::publishSnapshot() {
+    // Новый снимок на каждый тик: читатели держат старый, пока он им нужен
+    auto next = std::make_shared<SystemStats>();
+    next->cpu_percent = stats.cpu_percent;
+    next->core_percent = stats.core_percent;
+    next->cpu_breakdown = stats.cpu_breakdown;
+    next->context_switches_per_sec = stats.context_switches_per_sec;
+    next->interrupts_per_sec = stats.interrupts_per_sec;
+    next->forks_per_sec = stats.forks_per_sec;
+    next->procs_running = stats.procs_running;
+    next->procs_blocked = stats.procs_blocked;
+    next->total_memory_kb = stats.total_memory_kb;
+    next->used_memory_kb = stats.used_memory_kb;
+    next->free_memory_kb = stats.free_memory_kb;
+    next->memory_detail = stats.memory_detail;
+    next->pressure = stats.pressure;
+    next->cpu_pressure = stats.cpu_pressure;
+    next->memory_pressure = stats.memory_pressure;
+    next->io_pressure = stats.io_pressure;
+    std::copy(std::begin(stats.load_avg), std::end(stats.load_avg), next->load_avg);
+    next->process_count = stats.process_count;
+    next->proc_events = stats.proc_events;
+    next->short_lived_count = stats.short_lived_count;
+    next->short_lived = stats.short_lived;
+    next->taskstats = stats.taskstats;
+    next->cgroup_view = stats.cgroup_view;
+    next->cgroups = stats.cgroups;
+    next->tree_view = stats.tree_view;
+    
+    // Копируются только отображаемые строки; имя пользователя нужно только им
+    next->processes.reserve(view.size());
+    for (const ProcessInfo* proc : view) {
+        next->processes.push_back(*proc);
+        next->processes.back().user = getUserName(proc->uid);
+    }
+    if (stats.tree_view) {
+        const std::vector<int>& rows = tree.rows();
+        for (size_t i = 0; i < next->processes.size(); ++i) {
+            const ProcessTree::Node& node = tree.node(rows[i]);
+            ProcessInfo& proc = next->processes[i];
+            proc.depth = node.depth;
+            proc.last_child = node.next_sibling < 0;
+            proc.tree_cpu_percent = node.cpu_percent;
+            proc.tree_memory_kb = node.memory_kb;
+            proc.tree_processes = node.processes;
+        }
+    }
+    
+    // Под каждым процессом - max_threads самых загруженных потоков
+    for (const ThreadGroup& group : thread_groups) {
+        thread_view.clear();
+        for (size_t i = group.begin; i < group.end; ++i) {
+            ProcessRecord* record = thread_records.find(thread_ids[i]);
+            if (record && record->valid) thread_view.push_back(&record->info);
+        }
+        
+        size_t limit = config.max_threads > 0 ? std::min(thread_view.size(), static_cast<size_t>(config.max_threads))
+                                              : thread_view.size();
+        std::partial_sort(thread_view.begin(), thread_view.begin() + limit, thread_view.end(),
+                          [](const ProcessInfo* a, const ProcessInfo* b) {
+                              if (a->cpu_percent != b->cpu_percent) return a->cpu_percent > b->cpu_percent;
+                              return a->pid < b->pid;
+                          });
+        for (size_t i = 0; i < limit; ++i) {
+            next->threads.push_back(*thread_view[i]);
+            next->threads.back().tgid = group.pid;
+        }
+    }
+    
+    snapshot = std::move(next);
+}
+
+void SystemInfo::resolveFilterUsers(bool block) {
+    // Имена резолвит поток UserCache: фильтр, набираемый в '/', не ждет NSS.
+    // Пока имя не разрешено, оно не совпадает ни с одним процессом, и
+    // applyProcessFilters() повторяет попытку на каждом тике
+    users_pending = false;
+    show_only_uids.clear();
+    for (const auto& user : config.show_only_users) {
+        uid_t uid;
+        UserCache::UidLookup result = user_cache.lookupUid(user, uid, block);
+        if (result == UserCache::UidLookup::FOUND) {
+            show_only_uids.push_back(static_cast<int>(uid));
+        } else if (result == UserCache::UidLookup::PENDING) {
+            users_pending = true;
+        }
+    }
+    std::sort(show_only_uids.begin(), show_only_uids.end());
+    
+    for (auto& expr : filter_expressions) {
+        if (expr.field != FilterExpression::Field::USER) continue;
+        uid_t uid;
+        UserCache::UidLookup result = user_cache.lookupUid(expr.user, uid, block);
+        expr.uid = result == UserCache::UidLookup::FOUND ? static_cast<int>(uid) : -1;
+        if (result == UserCache::UidLookup::PENDING) {
+            users_pending = true;
+        }
+    }
+}
+
+void SystemInfo::compileNameFilter() {
+    // Строка фильтра вида cpu>5 - выражение, а не подстрока имени
+    FilterExpression expr;
+    if (parseFilterExpression(config.name_filter, expr)) {
+        name_filter.clear();
+    } else {
+        name_filter = config.name_filter;
+    }
+    for (auto& c : name_filter) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    hide_matcher.compile(config.hide_processes);
+    filter_generation++;
+}
+
+void SystemInfo::compileFilterExpressions() {
+    filter_expressions.clear();
+    filter_error.clear();
+    for (const auto& text : config.filters) {
+        FilterExpression expr;
+        if (parseFilterExpression(text, expr)) {
+            filter_expressions.push_back(std::move(expr));
+        } else {
+            filter_error += (filter_error.empty() ? "ignoring filter \"" : ", \"") + text + "\"";
+        }
+    }
+    FilterExpression expr;
+    if (parseFilterExpression(config.name_filter, expr)) {
+        filter_expressions.push_back(std::move(expr));
+    }
 }
 
 std::string SystemInfo::getUserName(int uid) {
-    struct passwd* pw = getpwuid(uid);
-    return pw ? std::string(pw->pw_name) : std::to_string(uid);
+    return user_cache.lookup(static_cast<uid_t>(uid));
 }
\ No newline at end of file
@@ -3,8 +3,21 @@
 
 #include <string>
 #include <vector>
+#include <list>
+#include <memory>
+#include <chrono>
 #include <cstdint>
 #include "parser.hpp"
+#include "cgroup.hpp"
+#include "collector_pool.hpp"
+#include "pid_table.hpp"
+#include "proc_events.hpp"
+#include "process_collector.hpp"
+#include "proc_file.hpp"
+#include "proc_parser.hpp"
+#include "process_filter.hpp"
+#include "process_tree.hpp"
+#include "user_cache.hpp"
 
 struct ProcessInfo {
     int pid;
@@ -15,44 +28,319 @@ struct ProcessInfo {
     std::string user;
     int uid;
     bool is_kernel_thread;
+    uint64_t cpu_time;   // utime + stime, jiffies
+    uint64_t start_time; // clock ticks since boot, detects PID reuse (sameStartTime)
+    int threads = 0;     // thread count from /proc/PID/stat, 0 = unknown
+    int tgid = 0;        // thread rows: the process the thread belongs to
+    int ppid = 0;        // parent process, 0 = none (init, kthreadd)
+    
+    // Filled by the taskstats collector only
+    uint64_t cpu_delay_ns = 0;   // waiting for a CPU while runnable
+    uint64_t blkio_delay_ns = 0; // waiting for block I/O (needs delay accounting)
+    uint64_t read_bytes = 0;     // storage I/O of the main thread
+    uint64_t write_bytes = 0;
+    
+    // From /proc/PID/smaps_rollup, memory_accounting = pss and shown rows only
+    bool smaps = false;  // the fields below are set
+    uint64_t pss_kb = 0;
+    uint64_t uss_kb = 0; // private pages
+    uint64_t swap_kb = 0;
+    
+    // Per-second rates from /proc/PID/io deltas: the shown rows, and when
+    // sorting by I/O also every process that used CPU since its last read
+    bool io = false;              // the rates below are set
+    double io_read_rate = 0.0;    // read_bytes: from storage
+    double io_write_rate = 0.0;   // write_bytes: sent to storage, incl. writeback
+    double rchar_rate = 0.0;      // all read() bytes, sockets and pipes too
+    double wchar_rate = 0.0;
+    double syscr_rate = 0.0;      // read syscalls
+    double syscw_rate = 0.0;
+    
+    // Tree view: position in the tree and totals of the subtree, the process
+    // itself included
+    int depth = 0;
+    bool last_child = false; // no later sibling, the branch ends here
+    double tree_cpu_percent = 0.0;
+    uint64_t tree_memory_kb = 0;
+    int tree_processes = 0;
+};
+
+// Two start_time reads of the same process. taskstats computes it from the
+// elapsed time, which may round to the neighbouring clock tick
+inline bool sameStartTime(uint64_t a, uint64_t b) {
+    return (a > b ? a - b : b - a) <= 1;
+}
+
+// Per-PID scan job; collector workers write only to their own tasks
+// and to the ProcessInfo each task points at
+struct ProcScanTask {
+    int pid;
+    int tgid;          // thread scan: the process of thread pid, 0 otherwise
+    int fd;            // cached stat fd, -1 if none
+    int new_fd;        // fd opened by the worker this tick
+    bool keep;         // a cache slot is reserved for new_fd, otherwise close it
+    bool stale;        // cached fd failed (ESRCH), must be dropped
+    ProcessInfo* info; // persistent entry, refreshed in place
+    bool check_uid;    // re-read the owner: new entry or periodic recheck
+    bool ok;           // info holds this tick's data
+};
+
+// Where CPU time went over the last interval, percent of all CPU time.
+// user and nice exclude guest time, which is reported on its own.
+struct CpuBreakdown {
+    double user = 0.0;
+    double nice = 0.0;
+    double system = 0.0;
+    double idle = 0.0;
+    double iowait = 0.0;
+    double irq = 0.0;
+    double softirq = 0.0;
+    double steal = 0.0; // taken by the hypervisor for other guests
+    double guest = 0.0; // running our own guests (guest + guest_nice)
 };
 
 struct SystemStats {
     double cpu_percent;
+    std::vector<float> core_percent; // busy % of each online CPU, /proc/stat order
+    CpuBreakdown cpu_breakdown;
+    
+    // Kernel activity from the same /proc/stat read, per second
+    double context_switches_per_sec = 0.0;
+    double interrupts_per_sec = 0.0;
+    double forks_per_sec = 0.0;
+    int procs_running = 0;
+    int procs_blocked = 0; // waiting for I/O
     uint64_t total_memory_kb;
     uint64_t used_memory_kb;
     uint64_t free_memory_kb;
+    MemInfo memory_detail;
     double load_avg[3];
+    
+    // Pressure stall information; false if the kernel has no /proc/pressure
+    bool pressure = false;
+    PressureInfo cpu_pressure;
+    PressureInfo memory_pressure;
+    PressureInfo io_pressure;
     int process_count;
     std::vector<ProcessInfo> processes;
+    
+    // Filled only while the proc connector backend is active
+    bool proc_events = false;
+    int short_lived_count = 0; // forked and exited within the last interval
+    std::vector<ShortLivedProcess> short_lived;
+    
+    // Processes come from the taskstats collector: delays and I/O bytes are
+    // filled, memory_kb is the peak RSS
+    bool taskstats = false;
+    
+    // group_by = cgroup: the visible processes aggregated per cgroup,
+    // sorted and capped like the process list
+    bool cgroup_view = false;
+    std::vector<CgroupInfo> cgroups;
+    
+    // tree_view: processes are in preorder, each followed by its subtree,
+    // with depth and subtree totals set
+    bool tree_view = false;
+    
+    // show_threads: the busiest threads of each shown process (pid = TID,
+    // tgid = the process), grouped by process, busiest first
+    std::vector<ProcessInfo> threads;
 };
 
 class SystemInfo {
 public:
     SystemInfo(const MtopConfig& config);
-    ~SystemInfo() = default;
+    ~SystemInfo();
     
-    SystemStats getStats();
+    SystemInfo(const SystemInfo&) = delete;
+    SystemInfo& operator=(const SystemInfo&) = delete;
+    
+    // Latest published snapshot; immutable, shared instead of copied
+    std::shared_ptr<const SystemStats> getStats() const;
     void updateStats();
     void updateConfig(const MtopConfig& new_config);
     
+    // Re-filters and re-sorts the last scan without rescanning /proc; only
+    // smaps_rollup of rows that became visible may be read
+    void rebuildView();
+    
+    // Why the proc connector could not be used; empty if it is active or off
+    const std::string& procEventsError() const { return proc_events_error; }
+    
+    // Why the requested taskstats collector is not used; empty otherwise
+    const std::string& collectorError() const { return collector_error; }
+    
+    // Why grouping by cgroup is unavailable; empty if it works or is off
+    const std::string& cgroupError() const { return cgroup_error; }
+    
+    // Filter expressions that could not be parsed; empty if all are valid
+    const std::string& filterError() const { return filter_error; }
+    
 private:
-    SystemStats stats;
+    SystemStats stats;          // system-wide fields of the current tick
+    std::vector<const ProcessInfo*> view;   // filtered and sorted rows of records
+    std::shared_ptr<const SystemStats> snapshot;
     MtopConfig config;
+    UserCache user_cache;
+    std::vector<int> show_only_uids; // show_only_users resolved to UIDs, sorted
+    bool users_pending;              // a filter user name is still being resolved
+    std::string name_filter;         // config.name_filter, lower-cased
+    PatternMatcher hide_matcher;     // config.hide_processes
+    std::vector<FilterExpression> filter_expressions; // config.filters and an expression name_filter
+    uint64_t filter_generation;      // bumped when the name filters are recompiled
+    std::string filter_error;
     uint64_t prev_total_time;
     uint64_t prev_idle_time;
+    KernelStat kernel_stat;      // /proc/stat of this tick
+    KernelStat prev_kernel_stat; // and of the previous one, swapped every tick
+    std::chrono::steady_clock::time_point prev_stat_time;
+    int proc_fd; // /proc directory, for fstatat() on PID entries
+    
+    // Push-based PID discovery; /proc is listed only on start and after lost events
+    ProcEvents proc_events;
+    std::string proc_events_error;
+    
+    // Long-lived procfs files, re-read with pread() every tick
+    ProcFile stat_file;
+    ProcFile meminfo_file;
+    ProcFile loadavg_file;
+    ProcFile cpu_pressure_file;
+    ProcFile memory_pressure_file;
+    ProcFile io_pressure_file;
+    std::vector<char> read_buf;
+    
+    // Persistent per-PID state carried between ticks. info keeps the fields
+    // that do not change (name, uid, kernel thread flag) and only the
+    // volatile ones are re-parsed each read.
+    struct ProcessRecord {
+        ProcessInfo info;
+        bool valid;              // info has been read successfully at least once
+        uint64_t cpu_time;       // utime + stime at the previous read
+        uint64_t start_time;     // starttime at the previous read, detects PID reuse
+        uint64_t memory_kb;      // RSS at the previous read
+        uint64_t sample_jiffies; // system jiffies at the previous read
+        uint64_t seen_tick;      // last tick the PID was listed in /proc
+        int idle_reads;          // consecutive reads with no CPU or RSS change
+        uint64_t next_read_tick; // idle backoff: stat is skipped until then
+        int stat_fd = -1;        // cached /proc/PID/stat descriptor
+        uint64_t fd_tick;        // last tick stat_fd was read
+        std::list<int>::iterator lru_pos;
+        
+        // cgroup v2 path, re-read on PID reuse and every cgroup_recheck_ticks
+        std::string cgroup;
+        uint64_t cgroup_start_time = 0;
+        CgroupMonitor::Group* group = nullptr; // set by readCgroups() each tick
+        
+        // Last smaps_rollup read of info, successful or not; epoch = never
+        std::chrono::steady_clock::time_point smaps_time;
+        
+        // /proc/PID/io at the previous read; io_time epoch = no baseline yet
+        ProcIo io;
+        std::chrono::steady_clock::time_point io_time;
+        uint64_t io_tick = 0;    // tick of the last read attempt
+        bool io_denied = false;  // not readable (another user's process), not retried
+        bool cpu_active = false; // CPU time grew at this tick's stat read
+        
+        // Verdict of the name filters (hide_processes, name_filter) for
+        // filter_name; re-matched only after a recompile or a name change
+        uint64_t filter_generation = 0;
+        std::string filter_name;
+        bool name_shown = false;
+    };
+    PidTable<ProcessRecord> records;
+    uint64_t tick;
+    uint64_t total_jiffies; // system jiffies of the current tick
+    int num_cpus;
+    
+    // Parallel /proc scan: workers refresh records in place, PID list reused between ticks
+    std::unique_ptr<CollectorPool> pool;
+    std::unique_ptr<ProcessCollector> collector;
+    MtopConfig::Collector collector_kind;
+    std::string collector_error;
+    std::vector<int> pids;
+    
+    std::vector<ProcScanTask> tasks;
+    std::vector<ProcessRecord*> task_records; // records[tasks[i].pid], stable during the scan
+    
+    // Bounded LRU of open stat fds (most recent first), sized from RLIMIT_NOFILE
+    std::list<int> fd_lru;
+    size_t fd_budget;
+    
+    // Groups of the cgroup view; refreshed only while group_by = cgroup
+    CgroupMonitor cgroup_monitor;
+    std::string cgroup_error;
+    uint64_t cgroup_tick; // tick of the last refresh, 0 = groups are not current
+    std::vector<ProcessRecord*> cgroup_records; // records whose path is re-read
+    
+    // Tree view of the filtered processes; view[i] is node tree.rows()[i]
+    ProcessTree tree;
+    std::vector<const ProcessInfo*> tree_view; // view in preorder, swapped into view
+    
+    std::vector<ProcessRecord*> smaps_records; // shown rows whose smaps_rollup is re-read
+    std::vector<ProcessRecord*> io_records;    // rows whose /proc/PID/io is read this pass
+    
+    // Thread view: the threads of the shown processes go through the same
+    // scan as processes, /proc/TID/stat into a second table keyed by TID
+    struct ThreadGroup {
+        int pid;
+        size_t begin; // range of thread_ids
+        size_t end;
+    };
+    PidTable<ProcessRecord> thread_records;
+    std::unique_ptr<ProcfsCollector> thread_collector;
+    std::vector<int> thread_ids;
+    std::vector<int> thread_owners;            // PID of each thread_ids entry
+    std::vector<ThreadGroup> thread_groups;
+    std::vector<int> task_ids;                 // listing of one /proc/PID/task
+    std::vector<const ProcessInfo*> thread_view;
+    uint64_t thread_tick;                      // tick of the last thread scan
+    std::vector<int> shown_pids;               // rebuild within a tick: rows of the new view, sorted
+    std::vector<int> grouped_pids;             // ... rows whose threads were already read, sorted
+    std::vector<int> rescan_ids;               // ... and the threads of newly shown rows
+    std::vector<int> rescan_owners;
     
     void readCpuStats();
     void readMemoryStats();
     void readProcesses();
+    void scanRecords(PidTable<ProcessRecord>& table, const std::vector<int>& ids,
+                     const std::vector<int>* owners, ProcessCollector& source, bool stat_fds);
+    void readThreads();
+    void configureCollector();
+    void configureProcEvents();
+    void configureCgroups();
+    void listPids();
+    void reserveStatFdSlots();
+    void updateStatFdCache();
+    void releaseStatFd(ProcessRecord& record);
     void readLoadAverage();
+    void readPressure();
+    void readCgroups();
+    void readSmaps();
+    void readIoCandidates();
+    void readShownIo();
+    void readProcessIo();
     std::string getUserName(int uid);
     double calculateCpuPercent(uint64_t total_time, uint64_t idle_time);
+    void calculateCpuBreakdown(uint64_t total_time);
+    void calculateKernelRates(double elapsed);
+    void updateProcessRecord(ProcessRecord& record);
+    bool shouldReadProcess(const ProcessRecord& record) const;
     
     // Process filtering
-    bool shouldShowProcess(const ProcessInfo& proc) const;
-    void sortProcesses();
+    bool shouldShowProcess(ProcessRecord& record);
+    bool matchesNameFilters(const std::string& name) const;
+    void compileNameFilter();
+    void compileFilterExpressions();
+    void resolveFilterUsers(bool block);
+    bool compareProcesses(const ProcessInfo& a, const ProcessInfo& b) const;
+    uint64_t sortMemoryKb(const ProcessInfo& proc) const;
     void applyProcessFilters();
+    void selectTopProcesses();
+    bool compareTreeNodes(int a, int b) const;
+    void buildTree();
+    bool compareCgroups(const CgroupInfo& a, const CgroupInfo& b) const;
+    void selectTopCgroups();
+    void publishSnapshot();
 };
 
 #endif // SYSTEM_INFO_HPP
\ No newline at end of file
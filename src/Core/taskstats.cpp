@@ -0,0 +1,324 @@
+#include "taskstats.hpp"
+#include "system_info.hpp"
+#include "proc_parser.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <linux/genetlink.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+// Процессов в одном send(): по два запроса на процесс, ответы (~600 байт)
+// должны поместиться в буфер сокета, иначе ядро их молча отбросит
+constexpr size_t batch_size = 32;
+
+// TASKSTATS_CMD_GET с одним атрибутом TASKSTATS_CMD_ATTR_PID/TGID
+struct Request {
+    struct nlmsghdr header;
+    struct genlmsghdr genl;
+    struct nlattr attr;
+    uint32_t pid;
+};
+static_assert(sizeof(Request) == NLMSG_LENGTH(GENL_HDRLEN + NLA_HDRLEN + sizeof(uint32_t)),
+              "request must match the netlink wire layout");
+
+void fillRequest(Request& request, uint16_t family, uint16_t attr_type, uint32_t pid, uint32_t seq) {
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = sizeof(Request);
+    request.header.nlmsg_type = family;
+    request.header.nlmsg_flags = NLM_F_REQUEST;
+    request.header.nlmsg_seq = seq;
+    request.genl.cmd = TASKSTATS_CMD_GET;
+    request.genl.version = TASKSTATS_GENL_VERSION;
+    request.attr.nla_type = attr_type;
+    request.attr.nla_len = NLA_HDRLEN + sizeof(uint32_t);
+    request.pid = pid;
+}
+
+// Ищет атрибут type среди атрибутов [data, data + size)
+const struct nlattr* findAttr(const char* data, size_t size, uint16_t type) {
+    while (size >= NLA_HDRLEN) {
+        const auto* attr = reinterpret_cast<const struct nlattr*>(data);
+        if (attr->nla_len < NLA_HDRLEN || attr->nla_len > size) return nullptr;
+        if ((attr->nla_type & NLA_TYPE_MASK) == type) return attr;
+        size_t step = std::min<size_t>(NLA_ALIGN(attr->nla_len), size);
+        data += step;
+        size -= step;
+    }
+    return nullptr;
+}
+
+const char* attrData(const struct nlattr* attr) {
+    return reinterpret_cast<const char*>(attr) + NLA_HDRLEN;
+}
+
+size_t attrSize(const struct nlattr* attr) {
+    return attr->nla_len - NLA_HDRLEN;
+}
+
+uint64_t bootTimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+} // namespace
+
+TaskstatsCollector::TaskstatsCollector(int proc_dir_fd) : proc_fd(proc_dir_fd), family_id(0) {
+    long ticks = sysconf(_SC_CLK_TCK);
+    clock_ticks = ticks > 0 ? ticks : 100;
+}
+
+TaskstatsCollector::~TaskstatsCollector() {
+    for (auto& channel : channels) {
+        closeChannel(channel);
+    }
+}
+
+bool TaskstatsCollector::open(std::string& error) {
+    channels.resize(1);
+    Channel& channel = channels.front();
+    if (!openChannel(channel, error) || !resolveFamily(channel, error)) {
+        return false;
+    }
+
+    // Без CAP_NET_ADMIN ядро отвечает EPERM на первый же запрос
+    uint32_t self = static_cast<uint32_t>(getpid());
+    query(channel, &self, 1);
+    if (!channel.replies[0].ok || !channel.replies[1].ok) {
+        error = std::string("taskstats: ") + strerror(errno ? errno : EPERM);
+        return false;
+    }
+    return true;
+}
+
+bool TaskstatsCollector::openChannel(Channel& channel, std::string& error) {
+    channel.fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (channel.fd < 0) {
+        error = std::string("netlink socket: ") + strerror(errno);
+        return false;
+    }
+
+    // Ответы на всю пачку лежат в буфере, пока мы их не прочитали
+    int rcvbuf = 4 << 20;
+    if (setsockopt(channel.fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) != 0) {
+        setsockopt(channel.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    // Потерянный ответ не должен подвесить сбор навсегда
+    struct timeval timeout = {1, 0};
+    setsockopt(channel.fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    if (bind(channel.fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        error = std::string("netlink bind: ") + strerror(errno);
+        closeChannel(channel);
+        return false;
+    }
+
+    channel.buffer.resize(1 << 16);
+    channel.replies.resize(2 * batch_size);
+    return true;
+}
+
+void TaskstatsCollector::closeChannel(Channel& channel) {
+    if (channel.fd >= 0) {
+        close(channel.fd);
+        channel.fd = -1;
+    }
+}
+
+bool TaskstatsCollector::resolveFamily(Channel& channel, std::string& error) {
+    // Имя семейства переводится в id через контроллер generic netlink
+    alignas(struct nlmsghdr) char message[NLMSG_SPACE(GENL_HDRLEN + NLA_HDRLEN + NLA_ALIGN(sizeof(TASKSTATS_GENL_NAME)))] = {};
+    auto* request = reinterpret_cast<struct nlmsghdr*>(message);
+    request->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN + NLA_HDRLEN + sizeof(TASKSTATS_GENL_NAME));
+    request->nlmsg_type = GENL_ID_CTRL;
+    request->nlmsg_flags = NLM_F_REQUEST;
+    request->nlmsg_seq = ++channel.seq;
+
+    auto* genl = static_cast<struct genlmsghdr*>(NLMSG_DATA(request));
+    genl->cmd = CTRL_CMD_GETFAMILY;
+    genl->version = 1;
+
+    auto* attr = reinterpret_cast<struct nlattr*>(reinterpret_cast<char*>(genl) + GENL_HDRLEN);
+    attr->nla_type = CTRL_ATTR_FAMILY_NAME;
+    attr->nla_len = NLA_HDRLEN + sizeof(TASKSTATS_GENL_NAME);
+    memcpy(reinterpret_cast<char*>(attr) + NLA_HDRLEN, TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME));
+
+    if (send(channel.fd, message, request->nlmsg_len, 0) < 0) {
+        error = std::string("genetlink: ") + strerror(errno);
+        return false;
+    }
+
+    ssize_t len = recv(channel.fd, channel.buffer.data(), channel.buffer.size(), 0);
+    if (len <= 0) {
+        error = std::string("genetlink: ") + strerror(errno);
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const struct nlmsghdr*>(channel.buffer.data());
+    if (!NLMSG_OK(header, static_cast<size_t>(len))) {
+        error = "genetlink: malformed reply";
+        return false;
+    }
+    if (header->nlmsg_type == NLMSG_ERROR) {
+        const auto* err = static_cast<const struct nlmsgerr*>(NLMSG_DATA(header));
+        error = std::string("taskstats: ") + strerror(-err->error) + " (kernel without CONFIG_TASKSTATS?)";
+        return false;
+    }
+
+    const char* attrs = static_cast<const char*>(NLMSG_DATA(header)) + GENL_HDRLEN;
+    const struct nlattr* id = findAttr(attrs, header->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), CTRL_ATTR_FAMILY_ID);
+    if (!id || attrSize(id) < sizeof(uint16_t)) {
+        error = "taskstats: family id not found";
+        return false;
+    }
+    memcpy(&family_id, attrData(id), sizeof(family_id));
+    return true;
+}
+
+void TaskstatsCollector::prepare(size_t workers) {
+    // Свой сокет на каждый поток пула; неудачный сокет останется с fd = -1
+    while (channels.size() > std::max<size_t>(workers, 1)) {
+        closeChannel(channels.back());
+        channels.pop_back();
+    }
+    while (channels.size() < workers) {
+        channels.emplace_back();
+        std::string error;
+        openChannel(channels.back(), error);
+    }
+}
+
+void TaskstatsCollector::query(Channel& channel, const uint32_t* pids, size_t count) {
+    Request requests[2 * batch_size];
+    uint32_t base = channel.seq + 1;
+    channel.seq += static_cast<uint32_t>(2 * count);
+
+    for (size_t i = 0; i < 2 * count; ++i) {
+        channel.replies[i].ok = false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        fillRequest(requests[2 * i], family_id, TASKSTATS_CMD_ATTR_TGID, pids[i], base + 2 * i);
+        fillRequest(requests[2 * i + 1], family_id, TASKSTATS_CMD_ATTR_PID, pids[i], base + 2 * i + 1);
+    }
+
+    // Ядро обрабатывает все сообщения одного send() подряд и отвечает на каждое
+    errno = 0;
+    uint64_t sent_ns = bootTimeNs();
+    channel.boot_ns = sent_ns;
+    if (send(channel.fd, requests, 2 * count * sizeof(Request), 0) < 0) return;
+
+    size_t pending = 2 * count;
+    while (pending > 0) {
+        ssize_t len = recv(channel.fd, channel.buffer.data(), channel.buffer.size(), 0);
+        if (len < 0 && (errno == EINTR || errno == ENOBUFS)) continue;
+        if (len <= 0) return; // таймаут: оставшиеся процессы в этом тике пропускаем
+
+        size_t size = static_cast<size_t>(len);
+        for (auto* header = reinterpret_cast<const struct nlmsghdr*>(channel.buffer.data());
+             NLMSG_OK(header, size); header = NLMSG_NEXT(header, size)) {
+            // Ответы на прошлую пачку, пришедшие после таймаута, отбрасываем
+            uint32_t index = header->nlmsg_seq - base;
+            if (index >= 2 * count) continue;
+            pending--;
+
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                // ESRCH - процесс завершился, EPERM - нет CAP_NET_ADMIN
+                errno = -static_cast<const struct nlmsgerr*>(NLMSG_DATA(header))->error;
+                continue;
+            }
+            if (header->nlmsg_type != family_id) continue;
+
+            // Ответ: AGGR_PID/AGGR_TGID { PID/TGID, STATS }
+            const char* attrs = static_cast<const char*>(NLMSG_DATA(header)) + GENL_HDRLEN;
+            size_t attrs_size = header->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN);
+            uint16_t aggr_type = (index % 2 == 0) ? TASKSTATS_TYPE_AGGR_TGID : TASKSTATS_TYPE_AGGR_PID;
+            const struct nlattr* aggr = findAttr(attrs, attrs_size, aggr_type);
+            if (!aggr) continue;
+            const struct nlattr* stats = findAttr(attrData(aggr), attrSize(aggr), TASKSTATS_TYPE_STATS);
+            if (!stats) continue;
+
+            // Структура растет от версии к версии: берем столько, сколько знаем
+            Reply& reply = channel.replies[index];
+            memset(&reply.stats, 0, sizeof(reply.stats));
+            memcpy(&reply.stats, attrData(stats), std::min(attrSize(stats), sizeof(reply.stats)));
+            reply.ok = true;
+        }
+    }
+
+    // Ядро считало ac_etime где-то между send() и последним ответом
+    channel.boot_ns = sent_ns + (bootTimeNs() - sent_ns) / 2;
+}
+
+void TaskstatsCollector::collect(size_t worker, ProcScanTask* tasks, size_t count) {
+    Channel* channel = worker < channels.size() ? &channels[worker] : nullptr;
+
+    for (size_t begin = 0; begin < count; begin += batch_size) {
+        size_t n = std::min(batch_size, count - begin);
+        ProcScanTask* batch = tasks + begin;
+
+        if (!channel || channel->fd < 0) {
+            for (size_t i = 0; i < n; ++i) batch[i].ok = false;
+            continue;
+        }
+
+        uint32_t pids[batch_size];
+        for (size_t i = 0; i < n; ++i) {
+            pids[i] = static_cast<uint32_t>(batch[i].pid);
+        }
+        query(*channel, pids, n);
+
+        for (size_t i = 0; i < n; ++i) {
+            const Reply& group = channel->replies[2 * i];
+            const Reply& leader = channel->replies[2 * i + 1];
+            ProcScanTask& task = batch[i];
+            task.ok = group.ok && leader.ok;
+            if (!task.ok) continue;
+
+            ProcessInfo& proc = *task.info;
+            const struct taskstats& thread = leader.stats;
+
+            proc.pid = task.pid;
+            size_t name_len = strnlen(thread.ac_comm, sizeof(thread.ac_comm));
+            if (proc.name.compare(0, std::string::npos, thread.ac_comm, name_len) != 0) {
+                proc.name.assign(thread.ac_comm, name_len);
+            }
+            proc.is_kernel_thread = isKernelThread(task.pid, static_cast<int>(thread.ac_ppid));
+            proc.ppid = static_cast<int>(thread.ac_ppid);
+            proc.state.assign(1, '?');
+            proc.memory_kb = thread.hiwater_rss;
+            // ac_btime - целые секунды, и при округлении прыгает на секунду между
+            // запросами. Время старта в тиках с загрузки, как starttime в
+            // /proc/PID/stat, получаем из ac_etime (мкс с момента запуска)
+            uint64_t elapsed_ns = thread.ac_etime * 1000;
+            uint64_t start_ns = channel->boot_ns > elapsed_ns ? channel->boot_ns - elapsed_ns : 0;
+            uint64_t start_time = start_ns / (1000000000 / static_cast<uint64_t>(clock_ticks));
+            if (!sameStartTime(proc.start_time, start_time)) {
+                task.check_uid = true; // PID переиспользован
+            }
+            proc.start_time = start_time;
+
+            // ac_uid - реальный UID; эффективный, как у procfs, - владелец /proc/PID
+            if (task.check_uid && !readProcOwner(proc_fd, task.pid, proc.uid)) {
+                task.ok = false;
+                continue;
+            }
+            proc.read_bytes = thread.read_bytes;
+            proc.write_bytes = thread.write_bytes;
+
+            // Время CPU всех потоков в микросекундах, CPU% считается в jiffies
+            const struct taskstats& all = group.stats;
+            proc.cpu_time = (all.ac_utime + all.ac_stime) * static_cast<uint64_t>(clock_ticks) / 1000000;
+            proc.cpu_delay_ns = all.cpu_delay_total;
+            proc.blkio_delay_ns = all.blkio_delay_total;
+        }
+    }
+}
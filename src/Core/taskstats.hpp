@@ -0,0 +1,63 @@
+#ifndef TASKSTATS_HPP
+#define TASKSTATS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <linux/taskstats.h>
+#include "process_collector.hpp"
+
+// Per-process accounting over the TASKSTATS generic netlink family: binary
+// records, no text parsing. Each process costs two queries, TGID (CPU time
+// and delays summed over all threads) and PID (name, parent, start time,
+// peak RSS and I/O bytes of the main thread), and the requests of a whole
+// batch go out in a single send(). Needs CAP_NET_ADMIN. Taskstats reports
+// neither the current RSS nor the run state: memory_kb holds the peak RSS
+// and state is "?".
+//
+// Taskstats carries the real UID and a start time in whole seconds; to
+// match ProcfsCollector the UID is taken from the owner of /proc/PID and the
+// start time is computed from the elapsed time (ac_etime).
+class TaskstatsCollector : public ProcessCollector {
+public:
+    explicit TaskstatsCollector(int proc_dir_fd);
+    ~TaskstatsCollector() override;
+
+    TaskstatsCollector(const TaskstatsCollector&) = delete;
+    TaskstatsCollector& operator=(const TaskstatsCollector&) = delete;
+
+    // Resolves the family and queries this process as a permission check
+    bool open(std::string& error);
+
+    const char* name() const override { return "taskstats"; }
+    bool usesStatFds() const override { return false; }
+    void prepare(size_t workers) override;
+    void collect(size_t worker, ProcScanTask* tasks, size_t count) override;
+
+private:
+    struct Reply {
+        bool ok;
+        struct taskstats stats; // zero-filled past the kernel's version
+    };
+
+    // One socket per pool worker, replies are matched by sequence number
+    struct Channel {
+        int fd = -1;
+        uint32_t seq = 0;
+        std::vector<char> buffer;
+        std::vector<Reply> replies; // [2i] TGID, [2i + 1] PID of the i-th process
+        uint64_t boot_ns = 0;       // CLOCK_BOOTTIME when the replies were made
+    };
+
+    int proc_fd; // /proc directory, owned by SystemInfo
+    uint16_t family_id;
+    long clock_ticks; // USER_HZ, the unit of ProcessInfo::cpu_time and start_time
+    std::vector<Channel> channels;
+
+    bool openChannel(Channel& channel, std::string& error);
+    void closeChannel(Channel& channel);
+    bool resolveFamily(Channel& channel, std::string& error);
+    void query(Channel& channel, const uint32_t* pids, size_t count);
+};
+
+#endif // TASKSTATS_HPP
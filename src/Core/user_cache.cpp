@@ -0,0 +1,173 @@
+#include "user_cache.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+time_t passwdMtime() {
+    struct stat st;
+    if (stat("/etc/passwd", &st) != 0) return 0;
+    return st.st_mtime;
+}
+
+size_t pwBufferSize() {
+    long size = sysconf(_SC_GETPW_R_SIZE_MAX);
+    return size > 0 ? static_cast<size_t>(size) : 16384;
+}
+
+} // namespace
+
+UserCache::UserCache(int ttl_seconds)
+    : stopping(false), ttl(ttl_seconds), passwd_mtime(passwdMtime()),
+      last_refresh(std::chrono::steady_clock::now()) {
+    worker = std::thread(&UserCache::run, this);
+}
+
+UserCache::~UserCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+std::string UserCache::lookup(uid_t uid) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = names.find(uid);
+    if (it != names.end()) {
+        return it->second;
+    }
+
+    // Неизвестный UID резолвится в фоне, пока показываем число
+    if (queued.insert(uid).second) {
+        pending.push_back(uid);
+        cv.notify_one();
+    }
+    return std::to_string(uid);
+}
+
+UserCache::UidLookup UserCache::lookupUid(const std::string& name, uid_t& uid, bool block) {
+    // UID числом не требует NSS
+    if (!name.empty() && std::all_of(name.begin(), name.end(), ::isdigit)) {
+        uid = static_cast<uid_t>(std::strtoul(name.c_str(), nullptr, 10));
+        return UidLookup::FOUND;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = uids.find(name);
+    if (it == uids.end()) {
+        if (!block) {
+            if (queued_names.insert(name).second) {
+                pending_names.push_back(name);
+                cv.notify_one();
+            }
+            return UidLookup::PENDING;
+        }
+        lock.unlock();
+        long resolved = resolveUid(name);
+        lock.lock();
+        it = uids.emplace(name, resolved).first;
+    }
+
+    if (it->second < 0) return UidLookup::UNKNOWN;
+    uid = static_cast<uid_t>(it->second);
+    return UidLookup::FOUND;
+}
+
+void UserCache::revalidate() {
+    auto now = std::chrono::steady_clock::now();
+    time_t mtime = passwdMtime();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    bool expired = ttl > 0 && now - last_refresh >= std::chrono::seconds(ttl);
+    if (mtime == passwd_mtime && !expired) {
+        return;
+    }
+
+    passwd_mtime = mtime;
+    last_refresh = now;
+
+    // Старые имена остаются видимыми, пока не придут новые
+    for (const auto& entry : names) {
+        if (queued.insert(entry.first).second) {
+            pending.push_back(entry.first);
+        }
+    }
+    for (const auto& entry : uids) {
+        if (queued_names.insert(entry.first).second) {
+            pending_names.push_back(entry.first);
+        }
+    }
+    cv.notify_one();
+}
+
+void UserCache::setTtl(int ttl_seconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ttl = ttl_seconds;
+}
+
+void UserCache::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        cv.wait(lock, [this] { return stopping || !pending.empty() || !pending_names.empty(); });
+        if (stopping) break;
+
+        if (!pending_names.empty()) {
+            std::string name = std::move(pending_names.back());
+            pending_names.pop_back();
+
+            lock.unlock();
+            long uid = resolveUid(name);
+            lock.lock();
+
+            uids[name] = uid;
+            queued_names.erase(name);
+            continue;
+        }
+
+        uid_t uid = pending.back();
+        pending.pop_back();
+
+        // NSS может блокироваться надолго - резолвим без мьютекса
+        lock.unlock();
+        std::string name = resolveName(uid);
+        lock.lock();
+
+        names[uid] = name;
+        queued.erase(uid);
+    }
+}
+
+std::string UserCache::resolveName(uid_t uid) {
+    std::vector<char> buffer(pwBufferSize());
+    struct passwd pw;
+    struct passwd* result = nullptr;
+
+    int err;
+    while ((err = getpwuid_r(uid, &pw, buffer.data(), buffer.size(), &result)) == ERANGE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    return (err == 0 && result) ? std::string(result->pw_name) : std::to_string(uid);
+}
+
+long UserCache::resolveUid(const std::string& name) {
+    std::vector<char> buffer(pwBufferSize());
+    struct passwd pw;
+    struct passwd* result = nullptr;
+
+    int err;
+    while ((err = getpwnam_r(name.c_str(), &pw, buffer.data(), buffer.size(), &result)) == ERANGE) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    return (err == 0 && result) ? static_cast<long>(result->pw_uid) : -1;
+}
@@ -0,0 +1,69 @@
+#ifndef USER_CACHE_HPP
+#define USER_CACHE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sys/types.h>
+
+// UID -> user name cache, and name -> UID for user filters. NSS lookups
+// (LDAP/SSSD can take seconds) run on a background thread; until a UID is
+// resolved its number is shown instead. Entries are re-resolved when
+// /etc/passwd changes or the TTL expires.
+class UserCache {
+public:
+    explicit UserCache(int ttl_seconds);
+    ~UserCache();
+
+    UserCache(const UserCache&) = delete;
+    UserCache& operator=(const UserCache&) = delete;
+
+    // Returns the cached name, or the numeric UID while the lookup is pending
+    std::string lookup(uid_t uid);
+
+    enum class UidLookup {
+        FOUND,
+        PENDING, // queued for the background thread
+        UNKNOWN  // no such user
+    };
+
+    // Name (or a number) -> UID from the cache. An unknown name is queued
+    // and PENDING is returned, unless block is set: then it is resolved on
+    // the calling thread (startup only, before anything waits on us).
+    UidLookup lookupUid(const std::string& name, uid_t& uid, bool block = false);
+
+    // Checks /etc/passwd mtime and the TTL, re-queues cached UIDs if stale.
+    // Called once per tick.
+    void revalidate();
+
+    void setTtl(int ttl_seconds);
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::unordered_map<uid_t, std::string> names;
+    std::unordered_set<uid_t> queued;
+    std::vector<uid_t> pending;
+    std::unordered_map<std::string, long> uids; // -1 = no such user
+    std::unordered_set<std::string> queued_names;
+    std::vector<std::string> pending_names;
+    bool stopping;
+
+    int ttl;
+    time_t passwd_mtime;
+    std::chrono::steady_clock::time_point last_refresh;
+
+    std::thread worker;
+
+    void run();
+    static std::string resolveName(uid_t uid);
+    static long resolveUid(const std::string& name);
+};
+
+#endif // USER_CACHE_HPP